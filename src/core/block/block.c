@@ -1,113 +1,120 @@
-﻿#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-#include <openssl/sha.h>
-#include <stdlib.h>
+﻿#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
 
 #include "wallet/wallet.h"
 #include "core/block/block.h"
+#include "crypto/hash.h"
+#include "core/block/miner.h"
+#include "core/block/merkle.h"
 #include <arpa/inet.h>
 
-// ----双重 SHA256----
-static void sha256d(const unsigned char* data, size_t len, unsigned char* out) {
-    unsigned char tmp[32];
-    SHA256(data, len, tmp);    // 第一次 SHA256
-    SHA256(tmp, 32, out);      // 第二次 SHA256
-}
-// 计算merkle根
-void compute_merkle_root(const Tx* txs, int tx_count, unsigned char* out) {
-    if (tx_count == 0) {
-        memset(out, 0, 32);
-        return;
-    }
-
-    // 临时保存每笔交易的哈希
-    unsigned char layer_hash[tx_count][32];
-
-    // 先计算每个交易的 txid
-    for (int i = 0; i < tx_count; i++) {
-        tx_hash(&txs[i], layer_hash[i]);
-    }
-
-    int count = tx_count;
-    // 不断向上合并，直到只剩一个根
-    while (count > 1) 
-    {
-        for (int i = 0; i < count / 2; i++)
-        {
-            unsigned char concat[64];
-
-            memcpy(concat, layer_hash[2 * i], 32);
-            memcpy(concat + 32, layer_hash[2 * i + 1], 32);
-
-            // 父节点 = SHA256D(左子 + 右子)
-            sha256d(concat, 64, layer_hash[i]);
-        }
-
-        // 若为奇数个节点：最后一个直接复制到下一层
-        if (count % 2 == 1) {
-            memcpy(layer_hash[count / 2], layer_hash[count - 1], 32);
-            count = count / 2 + 1;
-        }
-        else {
-            count = count / 2;
-        }
-    }
-
-    memcpy(out, layer_hash[0], 32);   // Merkle Root
+// 计算merkle根（txid 失效的交易重新哈希）
+void compute_merkle_root(Tx* txs, int tx_count, unsigned char* out) {
+    merkle_root_from_txs(txs, tx_count > 0 ? (size_t)tx_count : 0, out);
 }
 
 // ----计算区块头哈希----
 void compute_block_hash(const BlockHeader* h, unsigned char* out)
 {
-    SHA256_CTX ctx;
-    SHA256_Init(&ctx);
+    HashCtx ctx;
+    hash_init(&ctx);
     // 前一区块哈希
-    SHA256_Update(&ctx, h->prev_hash, 32);
+    hash_update(&ctx, h->prev_hash, 32);
     // merkle 根
-    SHA256_Update(&ctx, h->merkle_root, 32);
+    hash_update(&ctx, h->merkle_root, 32);
     // 转成网络序，保证跨平台一致性
     uint32_t t = htonl(h->timestamp);
     uint32_t n = htonl(h->nonce);
     uint32_t d = htonl(h->difficulty);
-    SHA256_Update(&ctx, &t, sizeof(t));
-    SHA256_Update(&ctx, &n, sizeof(n));
-    SHA256_Update(&ctx, &d, sizeof(d));
-    SHA256_Final(out, &ctx);
+    hash_update(&ctx, &t, sizeof(t));
+    hash_update(&ctx, &n, sizeof(n));
+    hash_update(&ctx, &d, sizeof(d));
+    hash_final(&ctx, out);
 }
 
-// ----挖矿功能----
-void mine_block(Block* b, uint32_t difficulty)
+// ----merkle 证明----
+int block_merkle_proof(Block* b, uint32_t tx_index, MerkleProof* proof)
 {
-    unsigned char hash[32];
+    if (!b || tx_index >= b->tx_count) return 0;
 
+    if (!b->merkle_cache) {
+        unsigned char* leaves = malloc((size_t)b->tx_count * 32);
+        if (!leaves) return 0;
+        for (uint32_t i = 0; i < b->tx_count; i++)
+            memcpy(leaves + 32 * i, tx_txid(&b->txs[i]), 32);
+
+        b->merkle_cache = merkle_tree_build(leaves, b->tx_count);
+        free(leaves);
+        if (!b->merkle_cache) return 0;
+    }
+    return merkle_tree_proof(b->merkle_cache, tx_index, proof);
+}
+
+int verify_merkle_proof(const BlockHeader* header, const unsigned char txid[32], const MerkleProof* proof)
+{
+    if (!header || !txid || !proof) return 0;
+    return merkle_proof_verify(proof, txid, header->merkle_root);
+}
+
+void block_merkle_cache_clear(Block* b)
+{
+    if (!b) return;
+    merkle_tree_free(b->merkle_cache);
+    b->merkle_cache = NULL;
+}
+
+// ----挖矿功能----
+// 交给多线程挖矿引擎搜索 nonce，在当前线程等待结果
+// 32 位 nonce 搜完后换一份新工作：有 coinbase 时递增其 extranonce（沿 coinbase 的 merkle 证明重算根），
+// 否则把 timestamp 加 1
+// cancel_gen 为读取链尾前的 miner_generation()：之后只要有 miner_cancel，即使发生在开始挖之前也会作废
+// 返回 1 表示挖到；返回 0 表示任务被取消（对端新区块已到）
+int mine_block(Block* b, uint32_t difficulty, unsigned int cancel_gen)
+{
     b->header.nonce = 0;
     b->header.difficulty = difficulty;   //难度设置
 
-    while (1)
-    {
-        compute_block_hash(&b->header, hash);
-
-        int valid = 1;
-        for (uint32_t i = 0; i < difficulty; i++)
-        {
-            if (hash[i] != 0)
-            {
-                valid = 0;
-                break;
+    Tx* coinbase = (b->tx_count > 0 && b->txs[0].input_count == 0) ? &b->txs[0] : NULL;
+    MerkleProof branch;
+    int have_branch = 0;
+
+    MiningResult result;
+    while (1) {
+        MiningJob job;
+        job.header = b->header;
+        job.cancel_gen = cancel_gen;
+
+        int status = miner_wait(miner_start(&job, NULL, NULL), &result);
+        if (status == MINER_FOUND) break;
+        if (status == MINER_CANCELLED) return 0;
+
+        if (coinbase) {
+            // coinbase 的兄弟节点与它自身无关，路径只取一次；之后缓存的树已过期
+            if (!have_branch) {
+                if (!block_merkle_proof(b, 0, &branch)) return 0;
+                have_branch = 1;
             }
-        }
-
-        if (valid)
-            break;
+            block_merkle_cache_clear(b);
 
-        b->header.nonce++;
+            coinbase->extranonce++;
+            coinbase->txid_valid = 0;
+            tx_txid(coinbase);
+            merkle_proof_root(&branch, coinbase->txid, b->header.merkle_root);
+            printf("Nonce space exhausted, extranonce = %u\n", coinbase->extranonce);
+        }
+        else {
+            b->header.timestamp++;
+            printf("Nonce space exhausted, timestamp = %u\n", b->header.timestamp);
+        }
     }
 
-    memcpy(b->header.block_hash, hash, 32);
+    b->header.nonce = result.nonce;
+    memcpy(b->header.block_hash, result.hash, 32);
 
     printf("Block mined successfully, nonce = %u\n", b->header.nonce);
+    return 1;
 }
 
 
@@ -140,13 +147,11 @@ Block* create_block(const unsigned char prev_hash[32], const Tx* txs, uint32_t t
     for (uint32_t i = 0; i < tx_count; i++)
     {
         memcpy(&a->txs[i], &txs[i], sizeof(Tx));
-        unsigned char txid[32];
-        tx_hash(&a->txs[i], txid);
-        memcpy(a->txs[i].txid, txid, 32);   // 保存 txid
+        tx_txid(&a->txs[i]);                // 源交易已算过 txid 时直接复用
     }
 
-    //  merkle 根
-    compute_merkle_root(a->txs, tx_count, a->header.merkle_root);
+    //  merkle 根（txid 都已就绪）
+    merkle_root_from_txids(a->txs, tx_count, a->header.merkle_root);
     // 区块时间、难度、初始 nonce
     a->header.timestamp = (uint32_t)time(NULL);
     a->header.nonce = 0;
@@ -160,6 +165,82 @@ Block* create_block(const unsigned char prev_hash[32], const Tx* txs, uint32_t t
 
 
 
+// ----区块模板----
+int block_template_init(BlockTemplate* t, const unsigned char prev_hash[32])
+{
+    memset(t, 0, sizeof(*t));
+    merkle_builder_init(&t->merkle);
+    memcpy(t->prev_hash, prev_hash, 32);
+
+    unsigned char empty[32] = { 0 };
+    return block_template_add_tx(t, empty);
+}
+
+int block_template_add_tx(BlockTemplate* t, const unsigned char txid[32])
+{
+    if (t->tx_count == t->capacity) {
+        uint32_t cap = t->capacity ? t->capacity * 2 : 16;
+        unsigned char (*txids)[32] = realloc(t->txids, 32 * (size_t)cap);
+        if (!txids) return 0;
+        t->txids = txids;
+        t->capacity = cap;
+    }
+
+    if (!merkle_builder_append(&t->merkle, txid)) return 0;
+    memcpy(t->txids[t->tx_count], txid, 32);
+
+    t->tx_count++;
+    return 1;
+}
+
+int block_template_set_coinbase(BlockTemplate* t, const unsigned char txid[32])
+{
+    if (t->tx_count == 0) return 0;
+
+    memcpy(t->txids[0], txid, 32);
+    return merkle_builder_set(&t->merkle, 0, txid);
+}
+
+Block* block_template_to_block(const BlockTemplate* t, Tx* const* txs)
+{
+    Block* a = malloc(sizeof(Block));
+    if (!a) return NULL;
+    memset(a, 0, sizeof(Block));
+
+    a->txs = malloc(sizeof(Tx) * t->tx_count);
+    if (!a->txs) {
+        free(a);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < t->tx_count; i++) {
+        // 交易内容与模板记录的 txid 不一致时 merkle 根就是错的
+        if (memcmp(tx_txid(txs[i]), t->txids[i], 32) != 0) {
+            free(a->txs);
+            free(a);
+            return NULL;
+        }
+        a->txs[i] = *txs[i];
+    }
+    a->tx_count = t->tx_count;
+
+    memcpy(a->header.prev_hash, t->prev_hash, 32);
+    merkle_builder_root(&t->merkle, a->header.merkle_root);
+    a->header.timestamp = (uint32_t)time(NULL);
+    a->header.nonce = 0;
+    a->header.difficulty = 1;
+    compute_block_hash(&a->header, a->header.block_hash);
+    return a;
+}
+
+void block_template_free(BlockTemplate* t)
+{
+    free(t->txids);
+    merkle_builder_free(&t->merkle);
+    memset(t, 0, sizeof(*t));
+}
+
+
+
 // ----释放区块所占内存----
 void free_block(Block* a)
 {
@@ -171,5 +252,6 @@ void free_block(Block* a)
             free_tx(&a->txs[i]);
         free(a->txs);
     }
+    merkle_tree_free(a->merkle_cache);
     free(a);
 }
@@ -5,6 +5,7 @@
 #include <time.h>
 
 #include <core/transaction.h>
+#include <core/block/merkle.h>
 
 
 // -----------------------------
@@ -29,9 +30,23 @@ typedef struct {
     uint32_t tx_count;
     Tx* txs;
 
+    MerkleTree* merkle_cache;         // ֤ʱ merkle 棨лfree_block ͷţ
 } Block;
 
 
+// -----------------------------
+// ģ壺txids[0] Ϊ coinbase֮Ǻѡ
+// merkle ά׷ӽס滻 coinbase  O(log n)ʱ
+// ģֻ txidнݣʱɵ÷ txid ṩǰĽ
+// -----------------------------
+typedef struct {
+    unsigned char (*txids)[32];
+    uint32_t tx_count;
+    uint32_t capacity;
+    MerkleBuilder merkle;
+    unsigned char prev_hash[32];      // ģڵβ
+} BlockTemplate;
+
 //
 // ӡϢã
 //
@@ -40,7 +55,7 @@ typedef struct {
 // -----------------------------
 // Merkle Root
 // -----------------------------
-void compute_merkle_root(const Tx* txs, int tx_count, unsigned char* out);
+void compute_merkle_root(Tx* txs, int tx_count, unsigned char* out);
 
 
 // -----------------------------
@@ -60,9 +75,33 @@ Block* create_block(const unsigned char prev_hash[32], const Tx* txs, uint32_t t
 
 
 // -----------------------------
-// ڿ
+// ģ
+// init ʱ coinbase λȷȫ txidinit / add_tx / set_coinbase ɹ 1
+// to_block ģ飺txs[i]  txids[i] ӦĽףֵǳ飩
+// merkle ֱȡģĸtxid Բʱ NULL
+// -----------------------------
+int block_template_init(BlockTemplate* t, const unsigned char prev_hash[32]);
+int block_template_add_tx(BlockTemplate* t, const unsigned char txid[32]);
+int block_template_set_coinbase(BlockTemplate* t, const unsigned char txid[32]);
+Block* block_template_to_block(const BlockTemplate* t, Tx* const* txs);
+void block_template_free(BlockTemplate* t);
+
+// -----------------------------
+// ڿ󣺳ɹ 1ȡ 0
+// nonce ʱд coinbasetxs[0] extranonce/txid  merkle  timestamp
+// cancel_gen ȡԶβ֮ǰ miner_generation()
+// -----------------------------
+int mine_block(Block* b, uint32_t difficulty, unsigned int cancel_gen);
+
+// -----------------------------
+// merkle ֤SPV
+// block_merkle_proof: һεʱΪ齨棬֮ÿֻ֤ O(log n) ڵ
+// verify_merkle_proof: ֻͷ֤ txid 
+// ޸ txs  block_merkle_cache_clear
 // -----------------------------
-void mine_block(Block* b, uint32_t difficulty);
+int block_merkle_proof(Block* b, uint32_t tx_index, MerkleProof* proof);
+int verify_merkle_proof(const BlockHeader* header, const unsigned char txid[32], const MerkleProof* proof);
+void block_merkle_cache_clear(Block* b);
 
 // -----------------------------
 // ͷ
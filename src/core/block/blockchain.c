@@ -2,6 +2,9 @@
 #include <string.h>
 #include <stdlib.h>
 #include "core/block/blockchain.h"
+#include "core/check_queue.h"
+#include "core/utxo_set.h"
+#include "wallet/wallet.h"
 
 
 // ----在链上添加节点----
@@ -29,7 +32,11 @@ Blockchain* blockchain_add(Blockchain* chain, Block* b) {
 
 
 // ----验证区块----
-int verify_block(const Block* block, const Block* prev) {
+int verify_block(Block* block, const Block* prev) {
+    return verify_block_owned(block, prev, NULL, NULL);
+}
+
+int verify_block_owned(Block* block, const Block* prev, spent_addr_fn addr_of, void* user) {
 
     /* --------------------------
      * 1. 检查 prev_hash
@@ -68,21 +75,82 @@ int verify_block(const Block* block, const Block* prev) {
         }
     }
 
+    /* --------------------------
+     * 4. 验证所有输入的签名（整块放进一个检查队列并行验证，交易池里验过的直接命中签名缓存）
+     *    公钥与被花费输出地址是否对应需要 UTXO 集，由 addr_of 提供地址时在同一个检查里一起比较
+     *    （见 block_spent_addr）；被花费的输出找不到时整个区块无效
+     * --------------------------*/
+    SigCheckQueue q;
+    check_queue_init(&q);
+    int sig_ok = 1;
+    for (uint32_t i = 0; i < block->tx_count && sig_ok; i++) {
+        Tx* tx = &block->txs[i];
+        if (!addr_of) {
+            sig_ok = check_queue_push_tx(&q, tx);
+            continue;
+        }
+
+        const unsigned char* txid = tx_txid(tx);
+        for (uint32_t j = 0; j < tx->input_count && sig_ok; j++) {
+            unsigned char addr_hash[20];
+            if (!addr_of(block, i, &tx->inputs[j], addr_hash, user)) {
+                printf(" Block validation failed: input spends unknown output.\n");
+                check_queue_free(&q);
+                return 0;
+            }
+            sig_ok = check_queue_push_input(&q, txid, &tx->inputs[j], addr_hash);
+        }
+    }
+    sig_ok = sig_ok && check_queue_wait(&q);
+    check_queue_free(&q);
+
+    if (!sig_ok) {
+        printf(" Block validation failed: invalid transaction signature.\n");
+        return 0;
+    }
+
     return 1;
 }
 
 
+// ----区块输入所花费输出的地址----
+int block_spent_addr(const Block* block, uint32_t tx_index, const TxIn* in,
+    unsigned char out[20], void* user)
+{
+    UTXO* utxo = find_utxo(user, in->txid, in->output_index);
+    if (utxo) {
+        memcpy(out, utxo->hash160, 20);
+        return 1;
+    }
+    for (uint32_t k = 0; k < tx_index; k++) {
+        Tx* prev = &block->txs[k];
+        if (memcmp(tx_txid(prev), in->txid, 32) == 0 && in->output_index < prev->output_count) {
+            utxo_addr_key(prev->outputs[in->output_index].addr, out);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
 // ----验证链----
+// 边验证边把区块应用到临时 UTXO 集上，后面的区块据此检查输入归属
 int verify_chain(const Blockchain* chain) {
     if (chain == NULL) return 0;
 
     const Blockchain* cur = chain;
     const Blockchain* prev = NULL;
     int height = 0;
+    UTXOSet* replay = NULL;
 
     while (cur) {
-        if (!verify_block(cur->block, prev ? prev->block : NULL)) {
+        Block* b = cur->block;
+        int ok = verify_block_owned(b, prev ? prev->block : NULL, block_spent_addr, replay);
+        for (uint32_t i = 0; i < b->tx_count && ok; i++)
+            ok = update_utxo_set(&replay, &b->txs[i], tx_txid(&b->txs[i]));
+        if (!ok) {
             printf("Blockchain verification failed at block index %d\n", height);
+            utxo_set_free(replay);
             return 0;
         }
 
@@ -90,6 +158,7 @@ int verify_chain(const Blockchain* chain) {
         cur = cur->next;
         height++;
     }
+    utxo_set_free(replay);
 
     printf("Blockchain verification successful! - total blocks: %d\n\n", height);
     return 1;
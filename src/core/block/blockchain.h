@@ -20,15 +20,32 @@ typedef struct BlockchainNode {
 Blockchain* blockchain_add(Blockchain* chain, Block* b);
 
 // ----------------------------
-// ֤
+// ֤Ӵطųʱ UTXO ÿ鶼
 // ----------------------------
 int verify_chain(const Blockchain* chain);
 
 
 // ----------------------------
-// ֤
+// ֤飨
+// ɻָǩûеַ޷ж˭ǩģᱻܾ verify_block_owned
 // ----------------------------
-int verify_block(const Block* block, const Block* prev);
+int verify_block(Block* block, const Block* prev);
+
+// ----------------------------
+// ֤鲢ǩ͡ԿӦַͬһɣÿǩֻһ
+// addr_of  tx_index ʽ׵ in ĵַ hash160д out  1
+// Ҳʱ 0Чaddr_of Ϊ NULL ʱͬ verify_block
+// ----------------------------
+typedef int (*spent_addr_fn)(const Block* block, uint32_t tx_index, const TxIn* in,
+    unsigned char out[20], void* user);
+int verify_block_owned(Block* block, const Block* prev, spent_addr_fn addr_of, void* user);
+
+// ----------------------------
+// spent_addr_fn ı׼ʵ֣user Ϊ UTXOSet*
+// ѵ UTXO ңڱǰĽ
+// ----------------------------
+int block_spent_addr(const Block* block, uint32_t tx_index, const TxIn* in,
+    unsigned char out[20], void* user);
 
 
 /**
@@ -0,0 +1,443 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/block/merkle.h"
+#include "crypto/hash.h"
+#include "utils/thread_pool.h"
+#include "wallet/wallet.h"
+
+// һôڵŽ̳߳
+#define MERKLE_PARALLEL_MIN   4096
+// ʱÿĽڵ
+#define MERKLE_TASK_NODES     1024
+// 󻺳Сͷţÿ̳߳ռŴڴ
+#define MERKLE_ARENA_KEEP     (1u << 20)
+
+// =====================================================
+// ÿ̸߳õĻ
+// =====================================================
+typedef struct {
+    unsigned char* buf;
+    size_t cap;
+} MerkleArena;
+
+static pthread_key_t g_arena_key;
+static pthread_once_t g_arena_once = PTHREAD_ONCE_INIT;
+
+static void arena_destroy(void* p)
+{
+    MerkleArena* a = p;
+    free(a->buf);
+    free(a);
+}
+
+static void arena_key_init(void)
+{
+    pthread_key_create(&g_arena_key, arena_destroy);
+}
+
+// ȡ bytes ֽڵĻʧܷ NULL
+static unsigned char* arena_get(size_t bytes)
+{
+    pthread_once(&g_arena_once, arena_key_init);
+
+    MerkleArena* a = pthread_getspecific(g_arena_key);
+    if (!a) {
+        a = calloc(1, sizeof(MerkleArena));
+        if (!a) return NULL;
+        pthread_setspecific(g_arena_key, a);
+    }
+    if (a->cap < bytes) {
+        unsigned char* buf = realloc(a->buf, bytes);
+        if (!buf) return NULL;
+        a->buf = buf;
+        a->cap = bytes;
+    }
+    return a->buf;
+}
+
+static void arena_trim(void)
+{
+    MerkleArena* a = pthread_getspecific(g_arena_key);
+    if (a && a->cap > MERKLE_ARENA_KEEP) {
+        free(a->buf);
+        a->buf = NULL;
+        a->cap = 0;
+    }
+}
+
+// =====================================================
+// 
+// =====================================================
+typedef struct {
+    const unsigned char* in;        // ڵ㣬 64 ֽ
+    unsigned char* out;             // һ
+    size_t pairs;
+} LevelJob;
+
+static void level_task(void* ctx, size_t index)
+{
+    LevelJob* job = ctx;
+    size_t start = index * MERKLE_TASK_NODES;
+    size_t n = job->pairs - start < MERKLE_TASK_NODES ? job->pairs - start : MERKLE_TASK_NODES;
+    hash_sha256d_64_batch(job->in + 64 * start, n, job->out + 32 * start);
+}
+
+typedef struct {
+    Tx* txs;
+    unsigned char* out;
+    size_t count;
+} LeafJob;
+
+static void leaf_task(void* ctx, size_t index)
+{
+    LeafJob* job = ctx;
+    size_t start = index * MERKLE_TASK_NODES;
+    size_t end = start + MERKLE_TASK_NODES < job->count ? start + MERKLE_TASK_NODES : job->count;
+    for (size_t i = start; i < end; i++)
+        memcpy(job->out + 32 * i, tx_txid(&job->txs[i]), 32);
+}
+
+static size_t task_count(size_t nodes)
+{
+    return (nodes + MERKLE_TASK_NODES - 1) / MERKLE_TASK_NODES;
+}
+
+// ----һ pairs Խڵϣ outout  in صڵʱ----
+static void hash_level(const unsigned char* in, size_t pairs, unsigned char* out)
+{
+    ThreadPool* pool = thread_pool_shared();
+    if (thread_pool_size(pool) > 1 && pairs * 2 >= MERKLE_PARALLEL_MIN) {
+        LevelJob job = { in, out, pairs };
+        thread_pool_run(pool, level_task, &job, task_count(pairs));
+    }
+    else {
+        hash_sha256d_64_batch(in, pairs, out);
+    }
+}
+
+// ---- buf е count Ҷϲ----
+// Сԭغϲ㲢ʱύΪд spare 󽻻
+static void merkle_reduce(unsigned char* buf, unsigned char* spare, size_t count, unsigned char out[32])
+{
+    int parallel = thread_pool_size(thread_pool_shared()) > 1;
+
+    while (count > 1) {
+        size_t pairs = count / 2;
+
+        if (parallel && count >= MERKLE_PARALLEL_MIN) {
+            hash_level(buf, pairs, spare);
+            if (count % 2 == 1)
+                memcpy(spare + 32 * pairs, buf + 32 * (count - 1), 32);
+            unsigned char* t = buf;
+            buf = spare;
+            spare = t;
+        }
+        else {
+            hash_sha256d_64_batch(buf, pairs, buf);
+            if (count % 2 == 1)
+                memcpy(buf + 32 * pairs, buf + 32 * (count - 1), 32);
+        }
+        count = pairs + count % 2;
+    }
+
+    memcpy(out, buf, 32);
+}
+
+// Ҷ count*32 ֽڣһһСı
+static unsigned char* merkle_buffers(size_t count, unsigned char** spare)
+{
+    size_t leaf_bytes = count * 32;
+    unsigned char* buf = arena_get(leaf_bytes + (count / 2 + 1) * 32);
+    if (buf) *spare = buf + leaf_bytes;
+    return buf;
+}
+
+// =====================================================
+// ӿ
+// =====================================================
+void merkle_root_from_hashes(const unsigned char* leaves, size_t count, unsigned char out[32])
+{
+    if (count == 0) {
+        memset(out, 0, 32);
+        return;
+    }
+    if (count == 1) {
+        memcpy(out, leaves, 32);
+        return;
+    }
+
+    unsigned char* spare;
+    unsigned char* buf = merkle_buffers(count, &spare);
+    if (!buf) {
+        memset(out, 0, 32);
+        return;
+    }
+    memcpy(buf, leaves, count * 32);
+    merkle_reduce(buf, spare, count, out);
+    arena_trim();
+}
+
+void merkle_root_from_txids(const Tx* txs, size_t count, unsigned char out[32])
+{
+    if (count == 0) {
+        memset(out, 0, 32);
+        return;
+    }
+
+    unsigned char* spare;
+    unsigned char* buf = merkle_buffers(count, &spare);
+    if (!buf) {
+        memset(out, 0, 32);
+        return;
+    }
+    for (size_t i = 0; i < count; i++)
+        memcpy(buf + 32 * i, txs[i].txid, 32);
+    merkle_reduce(buf, spare, count, out);
+    arena_trim();
+}
+
+void merkle_root_from_txs(Tx* txs, size_t count, unsigned char out[32])
+{
+    if (count == 0) {
+        memset(out, 0, 32);
+        return;
+    }
+
+    unsigned char* spare;
+    unsigned char* buf = merkle_buffers(count, &spare);
+    if (!buf) {
+        memset(out, 0, 32);
+        return;
+    }
+
+    ThreadPool* pool = thread_pool_shared();
+    if (thread_pool_size(pool) > 1 && count >= MERKLE_PARALLEL_MIN) {
+        LeafJob job = { txs, buf, count };
+        thread_pool_run(pool, leaf_task, &job, task_count(count));
+    }
+    else {
+        for (size_t i = 0; i < count; i++)
+            memcpy(buf + 32 * i, tx_txid(&txs[i]), 32);
+    }
+    merkle_reduce(buf, spare, count, out);
+    arena_trim();
+}
+
+// =====================================================
+// merkle ֤
+// =====================================================
+int merkle_proof_root(const MerkleProof* proof, const unsigned char leaf[32], unsigned char out[32])
+{
+    if (proof->tx_count == 0 || proof->tx_index >= proof->tx_count || proof->depth > MERKLE_MAX_DEPTH)
+        return 0;
+
+    unsigned char node[64];
+    memcpy(node, leaf, 32);
+
+    uint32_t index = proof->tx_index;
+    uint32_t count = proof->tx_count;
+    uint32_t k = 0;
+
+    while (count > 1) {
+        // һڵûֵܣֱ
+        if (!(index == count - 1 && count % 2 == 1)) {
+            if (k >= proof->depth) return 0;
+            if (index % 2 == 1) {
+                memcpy(node + 32, node, 32);
+                memcpy(node, proof->branch[k], 32);
+            }
+            else {
+                memcpy(node + 32, proof->branch[k], 32);
+            }
+            hash_sha256d(node, 64, node);
+            k++;
+        }
+        index /= 2;
+        count = count / 2 + count % 2;
+    }
+
+    if (k != proof->depth) return 0;
+    memcpy(out, node, 32);
+    return 1;
+}
+
+int merkle_proof_verify(const MerkleProof* proof, const unsigned char leaf[32], const unsigned char root[32])
+{
+    unsigned char calc[32];
+    if (!merkle_proof_root(proof, leaf, calc)) return 0;
+    return memcmp(calc, root, 32) == 0;
+}
+
+// =====================================================
+//  merkle 
+// =====================================================
+struct MerkleTree {
+    size_t leaf_count;
+    int levels;                                     // ҶӲ͸
+    size_t level_count[MERKLE_MAX_DEPTH + 1];       // ÿڵ
+    unsigned char* level[MERKLE_MAX_DEPTH + 1];     // ÿʼַ nodes 
+    unsigned char* nodes;
+};
+
+MerkleTree* merkle_tree_build(const unsigned char* leaves, size_t count)
+{
+    if (count == 0 || count > UINT32_MAX) return NULL;
+
+    // ڵ֮Ͳ 2 * count + 
+    size_t total = 0;
+    int levels = 0;
+    for (size_t c = count; ; c = c / 2 + c % 2) {
+        total += c;
+        levels++;
+        if (c == 1) break;
+    }
+
+    MerkleTree* tree = calloc(1, sizeof(MerkleTree));
+    if (!tree) return NULL;
+    tree->nodes = malloc(total * 32);
+    if (!tree->nodes) {
+        free(tree);
+        return NULL;
+    }
+
+    tree->leaf_count = count;
+    tree->levels = levels;
+
+    unsigned char* p = tree->nodes;
+    size_t c = count;
+    for (int l = 0; l < levels; l++) {
+        tree->level[l] = p;
+        tree->level_count[l] = c;
+        p += c * 32;
+        c = c / 2 + c % 2;
+    }
+
+    memcpy(tree->level[0], leaves, count * 32);
+    for (int l = 0; l + 1 < levels; l++) {
+        size_t n = tree->level_count[l];
+        hash_level(tree->level[l], n / 2, tree->level[l + 1]);
+        if (n % 2 == 1)
+            memcpy(tree->level[l + 1] + 32 * (n / 2), tree->level[l] + 32 * (n - 1), 32);
+    }
+    return tree;
+}
+
+void merkle_tree_free(MerkleTree* tree)
+{
+    if (!tree) return;
+    free(tree->nodes);
+    free(tree);
+}
+
+const unsigned char* merkle_tree_root(const MerkleTree* tree)
+{
+    return tree->level[tree->levels - 1];
+}
+
+int merkle_tree_proof(const MerkleTree* tree, uint32_t index, MerkleProof* proof)
+{
+    if (!tree || index >= tree->leaf_count) return 0;
+
+    proof->tx_index = index;
+    proof->tx_count = (uint32_t)tree->leaf_count;
+    proof->depth = 0;
+
+    size_t i = index;
+    for (int l = 0; l + 1 < tree->levels; l++) {
+        size_t n = tree->level_count[l];
+        size_t sibling = i ^ 1;
+        if (sibling < n)
+            memcpy(proof->branch[proof->depth++], tree->level[l] + 32 * sibling, 32);
+        i /= 2;
+    }
+    return 1;
+}
+
+// =====================================================
+//  merkle 
+// =====================================================
+void merkle_builder_init(MerkleBuilder* mb)
+{
+    memset(mb, 0, sizeof(*mb));
+}
+
+void merkle_builder_free(MerkleBuilder* mb)
+{
+    for (int l = 0; l <= MERKLE_MAX_DEPTH; l++)
+        free(mb->level[l]);
+    memset(mb, 0, sizeof(*mb));
+}
+
+static int builder_reserve(MerkleBuilder* mb, int l, size_t count)
+{
+    if (mb->cap[l] >= count) return 1;
+
+    size_t cap = mb->cap[l] ? mb->cap[l] * 2 : 16;
+    while (cap < count) cap *= 2;
+    unsigned char* p = realloc(mb->level[l], cap * 32);
+    if (!p) return 0;
+    mb->level[l] = p;
+    mb->cap[l] = cap;
+    return 1;
+}
+
+// ----ӵ 0  index 㵽----
+// ֵʱڵ = SHA256D( || )ûֵܣһʱֱ
+static int builder_update_path(MerkleBuilder* mb, size_t index)
+{
+    int l = 0;
+    while (mb->count[l] > 1) {
+        if (l == MERKLE_MAX_DEPTH) return 0;
+
+        size_t n = mb->count[l];
+        size_t parent_count = n / 2 + n % 2;
+        if (!builder_reserve(mb, l + 1, parent_count)) return 0;
+        mb->count[l + 1] = parent_count;
+
+        size_t left = index & ~(size_t)1;
+        unsigned char* dst = mb->level[l + 1] + 32 * (index / 2);
+        if (left + 1 < n)
+            hash_sha256d(mb->level[l] + 32 * left, 64, dst);
+        else
+            memcpy(dst, mb->level[l] + 32 * left, 32);
+
+        index /= 2;
+        l++;
+    }
+    mb->levels = l + 1;
+    return 1;
+}
+
+int merkle_builder_append(MerkleBuilder* mb, const unsigned char leaf[32])
+{
+    size_t n = mb->count[0];
+    if (n >= UINT32_MAX || !builder_reserve(mb, 0, n + 1)) return 0;
+
+    memcpy(mb->level[0] + 32 * n, leaf, 32);
+    mb->count[0] = n + 1;
+    return builder_update_path(mb, n);
+}
+
+int merkle_builder_set(MerkleBuilder* mb, size_t index, const unsigned char leaf[32])
+{
+    if (index >= mb->count[0]) return 0;
+
+    memcpy(mb->level[0] + 32 * index, leaf, 32);
+    return builder_update_path(mb, index);
+}
+
+size_t merkle_builder_count(const MerkleBuilder* mb)
+{
+    return mb->count[0];
+}
+
+void merkle_builder_root(const MerkleBuilder* mb, unsigned char out[32])
+{
+    if (mb->count[0] == 0) {
+        memset(out, 0, 32);
+        return;
+    }
+    memcpy(out, mb->level[mb->levels - 1], 32);
+}
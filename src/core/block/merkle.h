@@ -0,0 +1,80 @@
+#ifndef MERKLE_H
+#define MERKLE_H
+#include <stddef.h>
+#include <stdint.h>
+#include "core/transaction.h"
+
+// -----------------------------
+// merkle 
+// ڵ = SHA256D( || )һڵֱ
+// мÿ߳̿ɸõĶѻڽڵ϶ʱָ̳߳زйϣ
+// -----------------------------
+
+//  count ŵ 32 ֽҶӹϣcount Ϊ 0 ʱΪȫ 0
+void merkle_root_from_hashes(const unsigned char* leaves, size_t count, unsigned char out[32]);
+
+// ֱʹýѾõ txidظմ飩
+void merkle_root_from_txids(const Tx* txs, size_t count, unsigned char out[32]);
+
+// ͨ tx_txid ȡÿʽ׵ĹϣʧЧշлףʱ¼
+void merkle_root_from_txs(Tx* txs, size_t count, unsigned char out[32]);
+
+// -----------------------------
+// merkle ֤SPV
+// Եϼ¼ÿֵܽڵ㣻ĳ㱻ֱʱûֵܣռλ
+// ֤ tx_index  tx_count ƳÿλúǷ
+// -----------------------------
+#define MERKLE_MAX_DEPTH 32
+
+typedef struct {
+    uint32_t tx_index;
+    uint32_t tx_count;
+    uint32_t depth;                                 // branch еЧ
+    unsigned char branch[MERKLE_MAX_DEPTH][32];
+} MerkleProof;
+
+// Ҷӹϣ֤֤ʽԷ 0
+int merkle_proof_root(const MerkleProof* proof, const unsigned char leaf[32], unsigned char out[32]);
+
+//  leaf  proof ܷõ root
+int merkle_proof_verify(const MerkleProof* proof, const unsigned char leaf[32], const unsigned char root[32]);
+
+// -----------------------------
+//  merkle ÿһ㣬֮ÿֻ֤谴㿽ֵܽڵ㣬ٹϣ
+// -----------------------------
+typedef struct MerkleTree MerkleTree;
+
+MerkleTree* merkle_tree_build(const unsigned char* leaves, size_t count);
+void merkle_tree_free(MerkleTree* tree);
+
+const unsigned char* merkle_tree_root(const MerkleTree* tree);
+
+// ɵ index Ҷӵ֤index Խ緵 0
+int merkle_tree_proof(const MerkleTree* tree, uint32_t index, MerkleProof* proof);
+
+// -----------------------------
+//  merkle ģã
+// ׷Ҷӡ滻ĳҶӶֻһ·O(log n) ιϣ
+// -----------------------------
+typedef struct {
+    unsigned char* level[MERKLE_MAX_DEPTH + 1];     // ÿڵ
+    size_t count[MERKLE_MAX_DEPTH + 1];             // ÿڵ
+    size_t cap[MERKLE_MAX_DEPTH + 1];               // ÿ
+    int levels;                                     // ǰҶӲ͸
+} MerkleBuilder;
+
+void merkle_builder_init(MerkleBuilder* mb);
+void merkle_builder_free(MerkleBuilder* mb);
+
+// ׷һҶӣʧܷ 0
+int merkle_builder_append(MerkleBuilder* mb, const unsigned char leaf[32]);
+
+// 滻 index ҶӣԽ緵 0
+int merkle_builder_set(MerkleBuilder* mb, size_t index, const unsigned char leaf[32]);
+
+size_t merkle_builder_count(const MerkleBuilder* mb);
+
+// ǰûҶʱΪȫ 0
+void merkle_builder_root(const MerkleBuilder* mb, unsigned char out[32]);
+
+#endif
@@ -0,0 +1,320 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "core/block/miner.h"
+#include "crypto/sha256.h"
+
+// nonce ռ䰴 2^16 һַ߳һȡһ
+#define CHUNK_BITS   16
+#define CHUNK_COUNT  (1u << (32 - CHUNK_BITS))
+// ÿô nonce һȡ־
+#define CHECK_EVERY  4096
+
+typedef struct {
+    MinerRun* run;
+    int index;
+    pthread_t tid;
+} MinerWorker;
+
+struct MinerRun {
+    MiningJob job;
+    miner_found_fn cb;
+    void* user;
+
+    uint32_t midstate[8];           // prev_hash + merkle_root ѹ״̬
+    unsigned char tail[64];         // timestamp | nonce | difficulty | 
+
+    atomic_uint next_chunk;
+    atomic_int found;
+    unsigned int cancel_gen;        // ȡβʱȡ
+    MiningResult result;
+
+    const Sha256ScanKernel* kernel;
+    int threads;
+    int pin_cpus;
+    MinerWorker* workers;
+};
+
+static int g_threads = 0;
+static int g_pin_cpus = 0;
+static const Sha256ScanKernel* g_kernel = NULL;     // NULL ʱʹñں
+
+// miner_cancel ÿһμһµĴһ¾˵ѹ
+static atomic_uint g_cancel_gen;
+
+static void put_be32(unsigned char* p, uint32_t v)
+{
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+static int run_should_stop(MinerRun* run)
+{
+    return atomic_load_explicit(&run->found, memory_order_relaxed) ||
+        atomic_load_explicit(&g_cancel_gen, memory_order_relaxed) != run->cancel_gen;
+}
+
+static void pin_to_cpu(int index)
+{
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu <= 0) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % ncpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// һҵ̸߳дص߳˳
+static void report_nonce(MinerRun* run, uint32_t nonce)
+{
+    if (atomic_exchange(&run->found, 1) != 0) return;
+
+    BlockHeader h = run->job.header;
+    h.nonce = nonce;
+    run->result.nonce = nonce;
+    compute_block_hash(&h, run->result.hash);
+
+    if (run->cb)
+        run->cb(&run->job, &run->result, run->user);
+}
+
+// ----̣߳ȡ nonceɨں----
+static void* miner_worker(void* arg)
+{
+    MinerWorker* w = arg;
+    MinerRun* run = w->run;
+    const Sha256ScanKernel* kernel = run->kernel;
+    uint32_t difficulty = run->job.header.difficulty;
+
+    if (run->pin_cpus)
+        pin_to_cpu(w->index);
+
+    while (!run_should_stop(run)) {
+        unsigned int chunk = atomic_fetch_add(&run->next_chunk, 1);
+        if (chunk >= CHUNK_COUNT) break;
+
+        uint32_t base = (uint32_t)chunk << CHUNK_BITS;
+        for (uint32_t i = 0; i < (1u << CHUNK_BITS); i += CHECK_EVERY) {
+            if (run_should_stop(run))
+                return NULL;
+
+            uint32_t nonce;
+            if (kernel->scan(run->midstate, run->tail, base + i, CHECK_EVERY, difficulty, &nonce)) {
+                report_nonce(run, nonce);
+                return NULL;
+            }
+        }
+    }
+    return NULL;
+}
+
+void miner_configure(int threads, int pin_cpus)
+{
+    g_threads = threads;
+    g_pin_cpus = pin_cpus;
+}
+
+// --------
+MinerRun* miner_start(const MiningJob* job, miner_found_fn cb, void* user)
+{
+    MinerRun* run = calloc(1, sizeof(MinerRun));
+    if (!run) return NULL;
+
+    run->job = *job;
+    run->cb = cb;
+    run->user = user;
+    run->cancel_gen = job->cancel_gen;
+    atomic_init(&run->next_chunk, 0);
+    atomic_init(&run->found, 0);
+
+    // ͷǰ 64 ֽв䣬ֻѹһ
+    unsigned char head[64];
+    memcpy(head, job->header.prev_hash, 32);
+    memcpy(head + 32, job->header.merkle_root, 32);
+    sha256_midstate(head, run->midstate);
+
+    // β飺timestamp | nonce | difficulty | 0x80 |  |  76*8 bit
+    put_be32(run->tail, job->header.timestamp);
+    put_be32(run->tail + 8, job->header.difficulty);
+    run->tail[12] = 0x80;
+    run->tail[62] = (76 * 8) >> 8;
+    run->tail[63] = (76 * 8) & 0xff;
+
+    int threads = g_threads;
+    if (threads <= 0) {
+        long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = ncpu > 0 ? (int)ncpu : 1;
+    }
+    run->pin_cpus = g_pin_cpus;
+    run->kernel = g_kernel;
+    if (!run->kernel) {
+        int count;
+        run->kernel = &sha256_scan_kernels(&count)[0];
+    }
+
+    run->workers = calloc(threads, sizeof(MinerWorker));
+    if (!run->workers) {
+        free(run);
+        return NULL;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        run->workers[i].run = run;
+        run->workers[i].index = i;
+        if (pthread_create(&run->workers[i].tid, NULL, miner_worker, &run->workers[i]) != 0)
+            break;
+        run->threads++;
+    }
+
+    if (run->threads == 0) {
+        printf("[Miner] Failed to start worker threads.\n");
+        free(run->workers);
+        free(run);
+        return NULL;
+    }
+    return run;
+}
+
+// ----ȴ----
+int miner_wait(MinerRun* run, MiningResult* result)
+{
+    if (!run) return MINER_CANCELLED;
+
+    for (int i = 0; i < run->threads; i++)
+        pthread_join(run->workers[i].tid, NULL);
+
+    int status;
+    if (atomic_load(&run->found)) {
+        status = MINER_FOUND;
+        if (result) *result = run->result;
+    }
+    else if (atomic_load(&g_cancel_gen) != run->cancel_gen) {
+        status = MINER_CANCELLED;
+    }
+    else {
+        status = MINER_EXHAUSTED;
+    }
+
+    free(run->workers);
+    free(run);
+    return status;
+}
+
+// ----ȡне----
+void miner_cancel(void)
+{
+    atomic_fetch_add(&g_cancel_gen, 1);
+}
+
+unsigned int miner_generation(void)
+{
+    return atomic_load(&g_cancel_gen);
+}
+
+// =====================================================
+// ɨںѡԲ + 
+// =====================================================
+int miner_select_kernel(const char* name)
+{
+    int count;
+    const Sha256ScanKernel* kernels = sha256_scan_kernels(&count);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(kernels[i].name, name) == 0) {
+            g_kernel = &kernels[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char* miner_kernel_name(void)
+{
+    int count;
+    return g_kernel ? g_kernel->name : sha256_scan_kernels(&count)[0].name;
+}
+
+#define SELFTEST_NONCES (1u << 17)
+#define BENCH_NONCES    (1u << 16)
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ں˶ԱȣͬѶҵĵһ nonce һ
+static int kernel_selftest(const Sha256ScanKernel* k, const Sha256ScanKernel* ref,
+    const uint32_t midstate[8], const uint8_t tail[64])
+{
+    for (uint32_t zero_bytes = 0; zero_bytes <= 2; zero_bytes++) {
+        for (uint32_t start = 0; start < 3; start++) {
+            uint32_t a = 0, b = 0;
+            int fa = k->scan(midstate, tail, start * 977, SELFTEST_NONCES + start, zero_bytes, &a);
+            int fb = ref->scan(midstate, tail, start * 977, SELFTEST_NONCES + start, zero_bytes, &b);
+            if (fa != fb || (fa && a != b)) return 0;
+        }
+    }
+    return 1;
+}
+
+// ÿϣѶΪ 32 ֽڣ֤ɨ䣩
+static double kernel_bench(const Sha256ScanKernel* k, const uint32_t midstate[8], const uint8_t tail[64])
+{
+    double best = 1e9;
+    for (int r = 0; r < 3; r++) {
+        uint32_t nonce;
+        double t0 = now_seconds();
+        k->scan(midstate, tail, 0, BENCH_NONCES, 32, &nonce);
+        double t = now_seconds() - t0;
+        if (t < best) best = t;
+    }
+    return best > 0 ? BENCH_NONCES / best : 0;
+}
+
+const char* miner_autoselect_kernel(void)
+{
+    unsigned char head[64];
+    for (size_t i = 0; i < sizeof(head); i++)
+        head[i] = (unsigned char)(i * 37 + 11);
+    uint32_t midstate[8];
+    sha256_midstate(head, midstate);
+
+    uint8_t tail[64] = { 0 };
+    put_be32(tail, 0x5f5e1000);
+    put_be32(tail + 8, 2);
+    tail[12] = 0x80;
+    tail[62] = (76 * 8) >> 8;
+    tail[63] = (76 * 8) & 0xff;
+
+    int count;
+    const Sha256ScanKernel* kernels = sha256_scan_kernels(&count);
+    const Sha256ScanKernel* best = &kernels[0];
+    double best_rate = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && !kernel_selftest(&kernels[i], &kernels[0], midstate, tail)) {
+            printf("[Miner] kernel %s failed self-test, skipped\n", kernels[i].name);
+            continue;
+        }
+        double rate = kernel_bench(&kernels[i], midstate, tail);
+        printf("[Miner] kernel %s: %.2f MH/s per thread\n", kernels[i].name, rate / 1e6);
+        if (rate > best_rate) {
+            best_rate = rate;
+            best = &kernels[i];
+        }
+    }
+
+    g_kernel = best;
+    return g_kernel->name;
+}
@@ -0,0 +1,67 @@
+#ifndef MINER_H
+#define MINER_H
+#include <stdint.h>
+#include "core/block/block.h"
+
+// -----------------------------
+// ڿͷģ + Ŀ
+// ĿѶȡ header.difficultyϣǰ difficulty ֽΪ 0nonce д
+// cancel_gen Ϊȡβʱ miner_generation()֮ miner_cancel ֱ
+// -----------------------------
+typedef struct {
+    BlockHeader header;
+    unsigned int cancel_gen;
+} MiningJob;
+
+typedef struct {
+    uint32_t nonce;
+    unsigned char hash[32];
+} MiningResult;
+
+// ҵЧ nonce ʱڹ߳лصһ
+typedef void (*miner_found_fn)(const MiningJob* job, const MiningResult* result, void* user);
+
+//  miner_start أminer_wait ͷţ
+typedef struct MinerRun MinerRun;
+
+// ״̬
+#define MINER_FOUND      1
+#define MINER_CANCELLED  0
+#define MINER_EXHAUSTED -1      // 32 λ nonce ռȫ
+
+// -----------------------------
+// ãthreads <= 0 ʱʹ CPU pin_cpus  0 ʱѵ i ̰߳󶨵 i  CPU
+// -----------------------------
+void miner_configure(int threads, int pin_cpus);
+
+// -----------------------------
+// nonce ռ䰴ַ̣߳
+// -----------------------------
+MinerRun* miner_start(const MiningJob* job, miner_found_fn cb, void* user);
+
+// -----------------------------
+// ȴͷž MINER_FOUND / MINER_CANCELLED / MINER_EXHAUSTED
+// result Ϊ NULL
+// -----------------------------
+int miner_wait(MinerRun* run, MiningResult* result);
+
+// -----------------------------
+// ȡǰڽеյԶ˵飬βѱ仯
+// -----------------------------
+void miner_cancel(void);
+
+// -----------------------------
+// ǰȡڶȡβ֮ǰȡβһ𽻸
+// -----------------------------
+unsigned int miner_generation(void);
+
+// -----------------------------
+// nonce ɨںˣscalar / avx2-x8 / avx512-x16
+// miner_select_kernel ѡ񣬳ɹ 1
+// miner_autoselect_kernel ÿںȷԲⲢÿϣѡģ
+// -----------------------------
+int miner_select_kernel(const char* name);
+const char* miner_autoselect_kernel(void);
+const char* miner_kernel_name(void);
+
+#endif
@@ -0,0 +1,177 @@
+#include <stdlib.h>
+#include <string.h>
+#include <secp256k1.h>
+
+#include "core/check_queue.h"
+#include "core/sig_cache.h"
+#include "crypto/crypto_tools.h"
+#include "crypto/pubkey_cache.h"
+#include "utils/thread_pool.h"
+#include "wallet/wallet.h"
+
+// ֵʱֱڵǰִ߳Уʡȥ̳߳ص
+#define CHECK_PARALLEL_MIN  8
+// ÿļ
+#define CHECKS_PER_TASK     4
+
+void check_queue_init(SigCheckQueue* q)
+{
+    q->checks = NULL;
+    q->count = 0;
+    q->capacity = 0;
+    atomic_init(&q->failed, 0);
+    q->cache_store = 0;
+}
+
+void check_queue_free(SigCheckQueue* q)
+{
+    free(q->checks);
+    q->checks = NULL;
+    q->count = 0;
+    q->capacity = 0;
+}
+
+int check_queue_push(SigCheckQueue* q, const unsigned char sighash[32],
+    const unsigned char* pubkey, size_t pubkey_len,
+    const unsigned char* sig, size_t sig_len, const unsigned char* addr_hash)
+{
+    if (q->count == q->capacity) {
+        size_t cap = q->capacity ? q->capacity * 2 : 16;
+        SigCheck* p = realloc(q->checks, sizeof(SigCheck) * cap);
+        if (!p) return 0;
+        q->checks = p;
+        q->capacity = cap;
+    }
+
+    SigCheck* c = &q->checks[q->count++];
+    memcpy(c->sighash, sighash, 32);
+    c->pubkey = pubkey;
+    c->pubkey_len = pubkey_len;
+    c->sig = sig;
+    c->sig_len = sig_len;
+    c->has_addr = addr_hash != NULL;
+    if (addr_hash)
+        memcpy(c->addr_hash, addr_hash, 20);
+    return 1;
+}
+
+int check_queue_push_input(SigCheckQueue* q, const unsigned char sighash[32],
+    const TxIn* in, const unsigned char* addr_hash)
+{
+    // ȳĹԿ 0 ʱȻʧ
+    size_t publen = in->pubkey_len <= sizeof(in->pubkey) ? in->pubkey_len : 0;
+    return check_queue_push(q, sighash, in->pubkey, publen, in->signature, in->sig_len, addr_hash);
+}
+
+int check_queue_push_tx(SigCheckQueue* q, Tx* tx)
+{
+    const unsigned char* hash = tx_txid(tx);
+    for (uint32_t i = 0; i < tx->input_count; i++) {
+        if (!check_queue_push_input(q, hash, &tx->inputs[i], NULL))
+            return 0;
+    }
+    return 1;
+}
+
+// Կлʽ HASH160 ǷΪַ hash160 Base58 ַ
+static int addr_matches(const unsigned char* pub, size_t publen, const unsigned char addr_hash[20])
+{
+    unsigned char h[20];
+    hash160(pub, publen, h);
+    return memcmp(h, addr_hash, 20) == 0;
+}
+
+// ----ɻָǩǩ棬δʱָԿԿ棩ַѹԿ----
+// ûйԿ뻺 ָ id + ĵַ hash160 棺м˵ǩָĹԿַ
+//  65 ֽݶָܻĳԿûַʱǩʲôҲ֤ˣֱʧ
+static int run_recover_check(const secp256k1_context* ctx, const SigCheck* c, int store)
+{
+    if (!c->has_addr)
+        return 0;
+
+    unsigned char tag[21];
+    tag[0] = c->sig[64];
+    memcpy(tag + 1, c->addr_hash, 20);
+    if (sig_cache_contains(c->sighash, tag, sizeof(tag), c->sig))
+        return 1;
+
+    secp256k1_pubkey pub;
+    if (!pubkey_cache_recover(c->sig, c->sighash, &pub))
+        return 0;
+
+    unsigned char ser[33];
+    size_t len = sizeof(ser);
+    secp256k1_ec_pubkey_serialize(ctx, ser, &len, &pub, SECP256K1_EC_COMPRESSED);
+    if (!addr_matches(ser, len, c->addr_hash))
+        return 0;
+
+    if (store)
+        sig_cache_insert(c->sighash, tag, sizeof(tag), c->sig);
+    return 1;
+}
+
+// ----飺ǩ棬δʱԿԿ棩ǩǩ----
+static int run_check(const secp256k1_context* ctx, const SigCheck* c, int store)
+{
+    if (c->sig_len == TXIN_SIG_RECOVERABLE)
+        return run_recover_check(ctx, c, store);
+    if (c->sig_len != TXIN_SIG_COMPACT)
+        return 0;
+
+    if (c->has_addr && !addr_matches(c->pubkey, c->pubkey_len, c->addr_hash))
+        return 0;
+
+    if (sig_cache_contains(c->sighash, c->pubkey, c->pubkey_len, c->sig))
+        return 1;
+
+    secp256k1_pubkey pub;
+    if (!pubkey_cache_parse(c->pubkey, c->pubkey_len, &pub))
+        return 0;
+
+    secp256k1_ecdsa_signature sig;
+    if (!secp256k1_ecdsa_signature_parse_compact(ctx, &sig, c->sig))
+        return 0;
+
+    if (!secp256k1_ecdsa_verify(ctx, &sig, c->sighash, &pub))
+        return 0;
+
+    if (store)
+        sig_cache_insert(c->sighash, c->pubkey, c->pubkey_len, c->sig);
+    return 1;
+}
+
+static void check_task(void* arg, size_t index)
+{
+    SigCheckQueue* q = arg;
+    const secp256k1_context* ctx = crypto_secp_get_context();
+
+    size_t start = index * CHECKS_PER_TASK;
+    size_t end = start + CHECKS_PER_TASK < q->count ? start + CHECKS_PER_TASK : q->count;
+    for (size_t i = start; i < end; i++) {
+        if (atomic_load_explicit(&q->failed, memory_order_relaxed))
+            return;
+        if (!run_check(ctx, &q->checks[i], q->cache_store)) {
+            atomic_store(&q->failed, 1);
+            return;
+        }
+    }
+}
+
+int check_queue_wait(SigCheckQueue* q)
+{
+    atomic_store(&q->failed, 0);
+
+    if (q->count > 0) {
+        ThreadPool* pool = thread_pool_shared();
+        size_t tasks = (q->count + CHECKS_PER_TASK - 1) / CHECKS_PER_TASK;
+        if (q->count >= CHECK_PARALLEL_MIN && thread_pool_size(pool) > 1)
+            thread_pool_run(pool, check_task, q, tasks);
+        else
+            for (size_t t = 0; t < tasks; t++)
+                check_task(q, t);
+    }
+
+    int ok = !atomic_load(&q->failed);
+    q->count = 0;
+    return ok;
+}
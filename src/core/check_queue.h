@@ -0,0 +1,52 @@
+#ifndef CHECK_QUEUE_H
+#define CHECK_QUEUE_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#include "core/transaction.h"
+
+// ----ǩ飺sighash + Կ + ǩ----
+// sig_len Ϊ 64 ʱ pubkey ǩΪ 65 ʱǿɻָǩǩָԿ pubkey
+// has_addr Ϊ 1 ʱҪ HASH160(Կ)  addr_hashտַ hash160
+// ɻָǩ addr_hashʧ
+// pubkey/sig ָߵݣqueue ִ֮ǰͷţaddr_hash ƽ
+typedef struct {
+    unsigned char sighash[32];
+    const unsigned char* pubkey;
+    size_t pubkey_len;
+    const unsigned char* sig;
+    size_t sig_len;
+    unsigned char addr_hash[20];
+    int has_addr;
+} SigCheck;
+
+// ----ǩУռٽ̳߳ز֤----
+// 64 ֽǩȲǩ棨core/sig_cache.hмΪЧɻָǩԿָԿ
+typedef struct {
+    SigCheck* checks;
+    size_t count;
+    size_t capacity;
+    atomic_int failed;              // һʧܺ 1ֱ
+    int cache_store;                // ֤ͨǩдǩ棨׳Ϊ 1ֻѯ
+} SigCheckQueue;
+
+void check_queue_init(SigCheckQueue* q);
+void check_queue_free(SigCheckQueue* q);
+
+// һ飬ڴ治㷵 0
+int check_queue_push(SigCheckQueue* q, const unsigned char sighash[32],
+    const unsigned char* pubkey, size_t pubkey_len,
+    const unsigned char* sig, size_t sig_len, const unsigned char* addr_hash);
+
+// һ룻addr_hash Ϊѵĵַ hash16020 ֽڣʱ NULL
+int check_queue_push_input(SigCheckQueue* q, const unsigned char sighash[32],
+    const TxIn* in, const unsigned char* addr_hash);
+
+// 뽻׵ȫ루sighash Ϊ txid˿ɻָǩȻʧܣ
+int check_queue_push_tx(SigCheckQueue* q, Tx* tx);
+
+// ִжм鲢նУȫЧ 1һЧǩ󾡿췵 0
+int check_queue_wait(SigCheckQueue* q);
+
+#endif
@@ -0,0 +1,179 @@
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "core/sig_cache.h"
+#include "crypto/hash.h"
+
+// Ĭ 2^16 Ŀ2 MiB
+#define SIG_CACHE_DEFAULT   (1u << 16)
+// ÿͰĲÿĿѡͰ
+#define BUCKET_SLOTS        4
+// ʱŲôΣȻŲ¾Ͷ󱻼Ŀ
+#define MAX_KICKS           16
+
+typedef struct {
+    unsigned char key[32];          // ȫ 0 ʾղ
+} CacheSlot;
+
+typedef struct {
+    CacheSlot* slots;
+    size_t bucket_mask;             // Ͱ - 1
+    unsigned char salt[32];
+    uint64_t rng;                   // ѡλãдʹ
+    pthread_rwlock_t lock;
+} SigCache;
+
+static SigCache g_cache;
+static size_t g_entries = SIG_CACHE_DEFAULT;
+static pthread_once_t g_cache_once = PTHREAD_ONCE_INIT;
+
+static void create_cache(void)
+{
+    size_t buckets = 1;
+    while (buckets * BUCKET_SLOTS < g_entries)
+        buckets <<= 1;
+
+    g_cache.slots = calloc(buckets * BUCKET_SLOTS, sizeof(CacheSlot));
+    g_cache.bucket_mask = g_cache.slots ? buckets - 1 : 0;
+    pthread_rwlock_init(&g_cache.lock, NULL);
+
+    // ֵⲿ޷ͬһͰĿ
+    int fd = open("/dev/urandom", O_RDONLY);
+    ssize_t n = fd >= 0 ? read(fd, g_cache.salt, sizeof(g_cache.salt)) : -1;
+    if (fd >= 0) close(fd);
+    if (n != (ssize_t)sizeof(g_cache.salt))
+        printf("[SigCache] warning: failed to read random salt\n");
+
+    memcpy(&g_cache.rng, g_cache.salt, sizeof(g_cache.rng));
+    g_cache.rng ^= (uint64_t)time(NULL);
+    if (!g_cache.rng) g_cache.rng = 1;
+}
+
+void sig_cache_init(size_t entries)
+{
+    if (entries > 0)
+        g_entries = entries;
+    pthread_once(&g_cache_once, create_cache);
+}
+
+// Ŀ = SHA256(salt || sighash || Կ || Կ || ǩ)
+static void cache_key(const unsigned char sighash[32], const unsigned char* pubkey,
+    size_t pubkey_len, const unsigned char sig[64], unsigned char key[32])
+{
+    unsigned char len = (unsigned char)pubkey_len;
+    HashCtx ctx;
+    hash_init(&ctx);
+    hash_update(&ctx, g_cache.salt, 32);
+    hash_update(&ctx, sighash, 32);
+    hash_update(&ctx, &len, 1);
+    hash_update(&ctx, pubkey, pubkey_len);
+    hash_update(&ctx, sig, 64);
+    hash_final(&ctx, key);
+
+    // ȫ 0 ղ
+    static const unsigned char zero[32];
+    if (memcmp(key, zero, 32) == 0)
+        key[0] = 1;
+}
+
+// ѡͰֱȡԼĲͬλ
+static size_t bucket_of(const unsigned char key[32], int which)
+{
+    uint32_t w;
+    memcpy(&w, key + which * 4, 4);
+    return w & g_cache.bucket_mask;
+}
+
+static int slot_empty(const CacheSlot* s)
+{
+    static const unsigned char zero[32];
+    return memcmp(s->key, zero, 32) == 0;
+}
+
+static int bucket_find(size_t bucket, const unsigned char key[32])
+{
+    const CacheSlot* b = &g_cache.slots[bucket * BUCKET_SLOTS];
+    for (int i = 0; i < BUCKET_SLOTS; i++)
+        if (memcmp(b[i].key, key, 32) == 0)
+            return 1;
+    return 0;
+}
+
+static int bucket_put(size_t bucket, const unsigned char key[32])
+{
+    CacheSlot* b = &g_cache.slots[bucket * BUCKET_SLOTS];
+    for (int i = 0; i < BUCKET_SLOTS; i++) {
+        if (slot_empty(&b[i])) {
+            memcpy(b[i].key, key, 32);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t next_random(void)
+{
+    uint64_t x = g_cache.rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    g_cache.rng = x;
+    return (uint32_t)(x >> 32);
+}
+
+int sig_cache_contains(const unsigned char sighash[32],
+    const unsigned char* pubkey, size_t pubkey_len, const unsigned char sig[64])
+{
+    sig_cache_init(0);
+    if (!g_cache.slots) return 0;
+
+    unsigned char key[32];
+    cache_key(sighash, pubkey, pubkey_len, sig, key);
+
+    pthread_rwlock_rdlock(&g_cache.lock);
+    int hit = bucket_find(bucket_of(key, 0), key) || bucket_find(bucket_of(key, 1), key);
+    pthread_rwlock_unlock(&g_cache.lock);
+    return hit;
+}
+
+void sig_cache_insert(const unsigned char sighash[32],
+    const unsigned char* pubkey, size_t pubkey_len, const unsigned char sig[64])
+{
+    sig_cache_init(0);
+    if (!g_cache.slots) return;
+
+    unsigned char key[32];
+    cache_key(sighash, pubkey, pubkey_len, sig, key);
+
+    pthread_rwlock_wrlock(&g_cache.lock);
+
+    size_t b0 = bucket_of(key, 0), b1 = bucket_of(key, 1);
+    if (bucket_find(b0, key) || bucket_find(b1, key) || bucket_put(b0, key) || bucket_put(b1, key)) {
+        pthread_rwlock_unlock(&g_cache.lock);
+        return;
+    }
+
+    // ͰһĿᵽһͰ
+    size_t bucket = (next_random() & 1) ? b1 : b0;
+    for (int kick = 0; kick < MAX_KICKS; kick++) {
+        CacheSlot* s = &g_cache.slots[bucket * BUCKET_SLOTS + next_random() % BUCKET_SLOTS];
+        unsigned char victim[32];
+        memcpy(victim, s->key, 32);
+        memcpy(s->key, key, 32);
+        memcpy(key, victim, 32);
+
+        size_t v0 = bucket_of(key, 0), v1 = bucket_of(key, 1);
+        bucket = (bucket == v0) ? v1 : v0;
+        if (bucket_put(bucket, key))
+            break;
+    }
+    // ʱ󱻼ĿֱӶ̭
+
+    pthread_rwlock_unlock(&g_cache.lock);
+}
@@ -0,0 +1,22 @@
+#ifndef SIG_CACHE_H
+#define SIG_CACHE_H
+#include <stddef.h>
+
+// ----֤ǩ----
+// ¼֤ͨ (sighash, Կ, ǩ) Ԫ飬׽뽻׳ʱд룬
+// ͬһʽ鵽ʱֱУ ECDSA ǩ
+// ĿΪ SHA256 ժҪϣ̶ʱ̭߳̿ͬʱѯ
+// 65 ֽڿɻָǩûйԿpubkey  ָ id + ĵַsig ǰ 64 ֽ
+
+//  entries Ŀȡ 2 ݣȫֻ棻ʱһʹðĬ
+void sig_cache_init(size_t entries);
+
+// Ƿѻ
+int sig_cache_contains(const unsigned char sighash[32],
+    const unsigned char* pubkey, size_t pubkey_len, const unsigned char sig[64]);
+
+// дһ֤ͨļ¼
+void sig_cache_insert(const unsigned char sighash[32],
+    const unsigned char* pubkey, size_t pubkey_len, const unsigned char sig[64]);
+
+#endif
@@ -20,6 +20,8 @@ void transaction_init(Tx* t) {
     t->input_count = 0;
     t->outputs = NULL;
     t->output_count = 0;
+    t->extranonce = 0;
+    t->txid_valid = 0;
 }
 
 /*
@@ -38,6 +40,7 @@ void add_txin(Tx* tx, const unsigned char txid[32], uint32_t index) {
     tx->inputs[tx->input_count].pubkey_len = 0;
 
     tx->input_count++;
+    tx->txid_valid = 0;
 }
 
 /*
@@ -54,6 +57,7 @@ void add_txout(Tx* tx, const char* addr, uint32_t amount) {
     tx->outputs[tx->output_count].amount = amount;
 
     tx->output_count++;
+    tx->txid_valid = 0;
 }
 
 // 释放内存
@@ -69,6 +73,7 @@ void free_tx(Tx* tx) {
 
     tx->input_count = 0;
     tx->output_count = 0;
+    tx->txid_valid = 0;
 
 }
 
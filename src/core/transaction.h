@@ -24,13 +24,20 @@ typedef struct {
     unsigned char txid[32];        // õǰһʽ׵Ĺϣ (32 bytes)
     uint32_t output_index;         
 
-    unsigned char signature[64];   // ǩ
+    // ǩʽ
+    // sig_len == 65ɻָǩcompact 64 ֽ + recidԿ֤ʱǩָԿpubkey_len Ϊ 0
+    // sig_len == 64compact ǩԿ pubkey 
+    unsigned char signature[65];   // ǩ
     size_t sig_len;                // ǩ
 
-    unsigned char pubkey[65];      // Կ֤
-    size_t pubkey_len;             // Կ
+    unsigned char pubkey[33];      // ѹԿ 64 ֽǩʽʹãյķѹԿڷлʱתѹʽ
+    size_t pubkey_len;             // Կȣ33  0
 } TxIn;
 
+#define TXIN_SIG_COMPACT     64
+#define TXIN_SIG_RECOVERABLE 65
+#define TXIN_PUBKEY_LEN      33
+
 
 // --------
 typedef struct {
@@ -40,7 +47,10 @@ typedef struct {
     TxOut* outputs;                 //
     uint32_t output_count;          //
 
-    unsigned char txid[32];         //ǰĹϣID
+    uint32_t extranonce;            //coinbase nonce ı txid  merkle 
+
+    unsigned char txid[32];         //ǰĹϣID tx_txid 㲢
+    int txid_valid;                 //txid Ƿ뵱ǰһ£޸//extranonce  0
 } Tx;
 
 
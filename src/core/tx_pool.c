@@ -2,6 +2,8 @@
 #include <string.h>
 #include <stdio.h>
 #include "core/tx_pool.h"
+#include "core/check_queue.h"
+#include "utils/hex.h"
 
 
 /*void txpool_init(TxPool* pool) {
@@ -21,11 +23,9 @@ void tx_pool_print(const Mempool* pool) {
     }
 
     while (cur) {
-        printf("  txid: ");
-        for (int i = 0; i < 32; i++) {
-            printf("%02X", cur->txid[i]);
-        }
-        printf("\n");
+        char txid_hex[65];
+        hex_encode(cur->txid, 32, txid_hex);
+        printf("  txid: %s\n", txid_hex);
 
         cur = cur->next;
     }
@@ -51,9 +51,8 @@ static bool mempool_alreadyhave(Mempool* pool, const unsigned char txid[32]) {
 }
 
 // ӽ 
-bool tx_pool_add_tx(Mempool* pool, Tx* tx, UTXO* utxo_set) {
-    unsigned char txid[32];
-    tx_hash(tx, txid);
+bool tx_pool_add_tx(Mempool* pool, Tx* tx, UTXOSet* utxo_set) {
+    const unsigned char* txid = tx_txid(tx);
 
     /* ------- 1. ظ ------- */
     if (mempool_alreadyhave(pool, txid)) {
@@ -61,21 +60,35 @@ bool tx_pool_add_tx(Mempool* pool, Tx* tx, UTXO* utxo_set) {
         return false;
     }
 
-    /* ------- 2. ֤ǩ ------- */
-    if (!verify_tx(tx)) {
-        printf("[Mempool] Invalid signature, rejected.\n");
-        return false;
-    }
+    /* ------- 2. ֤ UTXO Ƿڣռǩ ------- */
+    // ÿĹԿɻָǩΪָĹԿӦĵַ
+    SigCheckQueue q;
+    check_queue_init(&q);
+    q.cache_store = 1;      // ͨǩдǩ棬֤ʱֱ
 
-    /* ------- 3. ֤ UTXO Ƿ ------- */
     for (uint32_t i = 0; i < tx->input_count; i++) {
         TxIn* in = &tx->inputs[i];
-        if (!find_utxo(utxo_set, in->txid, in->output_index)) {
+        UTXO* utxo = find_utxo(utxo_set, in->txid, in->output_index);
+        if (!utxo) {
             printf("[Mempool] Input UTXO not found, rejected.\n");
+            check_queue_free(&q);
+            return false;
+        }
+        if (!check_queue_push_input(&q, txid, in, utxo->hash160)) {
+            printf("[Mempool] Memory allocation failed!\n");
+            check_queue_free(&q);
             return false;
         }
     }
 
+    /* ------- 3. ֤ǩ ------- */
+    int sig_ok = check_queue_wait(&q);
+    check_queue_free(&q);
+    if (!sig_ok) {
+        printf("[Mempool] Invalid signature, rejected.\n");
+        return false;
+    }
+
     /* ------- 4. ȫͨ뽻׳ ------- */
     MempoolTx* node = malloc(sizeof(MempoolTx));
     if (!node) {
@@ -24,7 +24,7 @@ typedef struct {
 void tx_pool_init(Mempool* pool);
 
 //ӽ
-bool tx_pool_add_tx(Mempool* pool, Tx* tx, UTXO* utxo_set);
+bool tx_pool_add_tx(Mempool* pool, Tx* tx, UTXOSet* utxo_set);
 
 //ɾ
 bool tx_pool_remove_tx(Mempool* pool, const unsigned char txid[32]);
@@ -1,46 +1,523 @@
 #include "core/utxo_set.h"
+#include "utils/hex.h"
+#include "crypto/base58.h"
+#include "crypto/hash.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
 
 
 
+// =====================================================
+// ϣ
+// =====================================================
+#define UTXO_BUCKET_SLOTS   6
+#define UTXO_MIN_BUCKETS    16
+#define UTXO_MIGRATE_STEP   8       // ڼÿɾ˳ľͰ
+
+// һͰһУ12 ָֽ +  + 6 ¼ָ
+typedef struct {
+    uint16_t tags[UTXO_BUCKET_SLOTS];   // ϣ 16 λ0 ʾղ
+    uint16_t overflow;                  // ͰʱŵĿΪ 0 ʱҿڴͣ
+    uint16_t count;
+    UTXO* items[UTXO_BUCKET_SLOTS];
+} __attribute__((aligned(64))) UtxoBucket;
+
+typedef struct {
+    UtxoBucket* buckets;                // NULL ʾûű
+    size_t mask;                        // Ͱ - 1
+    size_t count;
+} UtxoTable;
+
+// ----ַhash160 -> õַıҺ----
+#define UTXO_ADDR_VERSION   0xA1        // Ǯɵַİ汾ֽһ
+#define ADDR_MIN_SLOTS      64
+
+typedef struct {
+    unsigned char key[20];              // hash160Ǳ׼ַΪ SHA256 ǰ 20 ֽڣ
+    uint32_t count;
+    uint32_t cap;
+    uint64_t balance;                   // õַбҵĽ֮
+    UTXO** coins;
+    char* label;                        // Ǳ׼ַԭģ޷Ӽԭ׼ַΪ NULL
+} AddrEntry;
+
+// ----¼䣺 slab 룬ͷŵļ¼ҵϸ----
+#define UTXO_SLAB_RECORDS   1024        // ÿ slab 64 KiB
+
+typedef union UtxoSlot {
+    UTXO rec;
+    union UtxoSlot* next_free;
+} UtxoSlot;
+
+struct UTXOSet {
+    UtxoTable cur;                      // Ŀ嵽
+    UtxoTable old;                      // δľɱ
+    size_t migrate_pos;                 // ɱһҪͰ
+    uint64_t seed;                      // ӣⲿ޷ͻ txid
+
+    AddrEntry* addrs;                   // ַĿż±꣬ɾʱĩβĿλ
+    uint32_t addr_count;
+    uint32_t addr_cap;
+    uint32_t* addr_slots;               // ̽ +10 Ϊ
+    size_t addr_mask;
+
+    UtxoSlot** slabs;                   //  slabͷʱһͷ
+    size_t slab_count;
+    size_t slab_cap;
+    size_t slab_used;                   //  slab гļ¼
+    UtxoSlot* free_list;
+};
+
+static uint64_t mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// txid ǹϣȡǰ 16 ֽں±ϼ
+static uint64_t utxo_hash(const UTXOSet* set, const unsigned char txid[32], uint32_t index) {
+    uint64_t a, b;
+    memcpy(&a, txid, 8);
+    memcpy(&b, txid + 8, 8);
+    return mix64(a ^ set->seed) ^ mix64(b + ((uint64_t)index << 32 | index));
+}
+
+static uint16_t hash_tag(uint64_t h) {
+    uint16_t tag = (uint16_t)(h >> 48);
+    return tag ? tag : 1;
+}
+
+static int table_init(UtxoTable* t, size_t buckets) {
+    t->buckets = aligned_alloc(64, buckets * sizeof(UtxoBucket));
+    if (!t->buckets) return 0;
+    memset(t->buckets, 0, buckets * sizeof(UtxoBucket));
+    t->mask = buckets - 1;
+    t->count = 0;
+    return 1;
+}
+
+// ңͰͲۣҲ NULL
+static UtxoBucket* table_find(const UtxoTable* t, uint64_t h, const unsigned char txid[32], uint32_t index, int* slot) {
+    if (!t->buckets || !t->count) return NULL;
+    uint16_t tag = hash_tag(h);
+    size_t b = h & t->mask;
+
+    for (size_t probes = 0; probes <= t->mask; probes++) {
+        UtxoBucket* bk = &t->buckets[b];
+        for (int s = 0; s < UTXO_BUCKET_SLOTS; s++) {
+            if (bk->tags[s] != tag) continue;
+            const UTXO* u = bk->items[s];
+            if (u->output_index == index && memcmp(u->txid, txid, 32) == 0) {
+                *slot = s;
+                return bk;
+            }
+        }
+        if (!bk->overflow) return NULL;
+        b = (b + 1) & t->mask;
+    }
+    return NULL;
+}
+
+// 룺ʼͰҵһпղ۵Ͱ·Ͱһ÷֤пλ
+static void table_insert(UtxoTable* t, uint64_t h, UTXO* u) {
+    size_t b = h & t->mask;
+    while (t->buckets[b].count == UTXO_BUCKET_SLOTS) {
+        t->buckets[b].overflow++;
+        b = (b + 1) & t->mask;
+    }
+
+    UtxoBucket* bk = &t->buckets[b];
+    int s = 0;
+    while (bk->tags[s]) s++;
+    bk->tags[s] = hash_tag(h);
+    bk->items[s] = u;
+    bk->count++;
+    t->count++;
+}
+
+// ɾղλٰʼͰͰ֮ȥ
+static UTXO* table_erase(UtxoTable* t, uint64_t h, UtxoBucket* bk, int slot) {
+    UTXO* u = bk->items[slot];
+    bk->tags[slot] = 0;
+    bk->items[slot] = NULL;
+    bk->count--;
+    t->count--;
+
+    size_t target = (size_t)(bk - t->buckets);
+    for (size_t b = h & t->mask; b != target; b = (b + 1) & t->mask)
+        t->buckets[b].overflow--;
+    return u;
+}
+
+// ѾɱɸͰ±δߵĿܲ鵽
+static void migrate_buckets(UTXOSet* set, size_t n) {
+    UtxoTable* old = &set->old;
+    if (!old->buckets) return;
+
+    size_t total = old->mask + 1;
+    for (; n > 0 && set->migrate_pos < total; n--, set->migrate_pos++) {
+        UtxoBucket* bk = &old->buckets[set->migrate_pos];
+        for (int s = 0; s < UTXO_BUCKET_SLOTS && bk->count; s++) {
+            if (!bk->tags[s]) continue;
+            UTXO* u = bk->items[s];
+            table_insert(&set->cur, utxo_hash(set, u->txid, u->output_index), u);
+            bk->tags[s] = 0;
+            bk->items[s] = NULL;
+            bk->count--;
+            old->count--;
+        }
+    }
+
+    if (set->migrate_pos == total) {
+        free(old->buckets);
+        old->buckets = NULL;
+        old->count = 0;
+    }
+}
+
+// װʳ 3/4 ʱһ±ɱ֮𲽰
+static int ensure_room(UTXOSet* set) {
+    size_t slots = (set->cur.mask + 1) * UTXO_BUCKET_SLOTS;
+    if ((set->cur.count + set->old.count + 1) * 4 <= slots * 3)
+        return 1;
+
+    // һֻû꣬һΰ
+    migrate_buckets(set, SIZE_MAX);
+
+    UtxoTable bigger;
+    if (!table_init(&bigger, (set->cur.mask + 1) * 2)) return 0;
+    set->old = set->cur;
+    set->cur = bigger;
+    set->migrate_pos = 0;
+    return 1;
+}
+
+static UTXO* record_alloc(UTXOSet* set) {
+    UtxoSlot* slot = set->free_list;
+    if (slot) {
+        set->free_list = slot->next_free;
+        return &slot->rec;
+    }
+
+    if (!set->slab_count || set->slab_used == UTXO_SLAB_RECORDS) {
+        if (set->slab_count == set->slab_cap) {
+            size_t cap = set->slab_cap ? set->slab_cap * 2 : 16;
+            UtxoSlot** slabs = realloc(set->slabs, cap * sizeof(UtxoSlot*));
+            if (!slabs) return NULL;
+            set->slabs = slabs;
+            set->slab_cap = cap;
+        }
+        UtxoSlot* slab = aligned_alloc(64, UTXO_SLAB_RECORDS * sizeof(UtxoSlot));
+        if (!slab) return NULL;
+        set->slabs[set->slab_count++] = slab;
+        set->slab_used = 0;
+    }
+    return &set->slabs[set->slab_count - 1][set->slab_used++].rec;
+}
+
+static void record_free(UTXOSet* set, UTXO* u) {
+    if (!u) return;
+    UtxoSlot* slot = (UtxoSlot*)u;
+    slot->next_free = set->free_list;
+    set->free_list = slot;
+}
+
+static UTXOSet* utxo_set_create(void) {
+    UTXOSet* set = calloc(1, sizeof(UTXOSet));
+    if (!set) return NULL;
+    if (!table_init(&set->cur, UTXO_MIN_BUCKETS)) {
+        free(set);
+        return NULL;
+    }
+
+    int fd = open("/dev/urandom", O_RDONLY);
+    ssize_t n = fd >= 0 ? read(fd, &set->seed, sizeof(set->seed)) : -1;
+    if (fd >= 0) close(fd);
+    if (n != (ssize_t)sizeof(set->seed))
+        set->seed = (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)set;
+    return set;
+}
+
+// =====================================================
+// ַ
+// =====================================================
+// ׼ַȡ Base58Check  hash160ⲻĵַ汾ԡУַȡ
+//  1 ʾ׼ַ
+static int addr_key(const char* addr, unsigned char key[20]) {
+    unsigned char payload[21];
+    if (base58check_decode(addr, payload, sizeof(payload)) == sizeof(payload) &&
+        payload[0] == UTXO_ADDR_VERSION) {
+        memcpy(key, payload + 1, 20);
+        return 1;
+    }
+
+    unsigned char h[32];
+    hash_sha256(addr, strlen(addr), h);
+    memcpy(key, h, 20);
+    return 0;
+}
+
+void utxo_addr_key(const char* addr, unsigned char key[20]) {
+    addr_key(addr, key);
+}
+
+static size_t addr_slot_of(const UTXOSet* set, const unsigned char key[20]) {
+    uint64_t k;
+    memcpy(&k, key, 8);
+    return mix64(k ^ set->seed) & set->addr_mask;
+}
+
+// ҵַĿҲ NULL
+static AddrEntry* addr_find(const UTXOSet* set, const unsigned char key[20]) {
+    if (!set->addr_slots) return NULL;
+    for (size_t i = addr_slot_of(set, key);; i = (i + 1) & set->addr_mask) {
+        uint32_t e = set->addr_slots[i];
+        if (!e) return NULL;
+        if (memcmp(set->addrs[e - 1].key, key, 20) == 0) return &set->addrs[e - 1];
+    }
+}
+
+static int addr_slots_grow(UTXOSet* set) {
+    size_t slots = set->addr_slots ? (set->addr_mask + 1) * 2 : ADDR_MIN_SLOTS;
+    uint32_t* table = calloc(slots, sizeof(uint32_t));
+    if (!table) return 0;
+
+    free(set->addr_slots);
+    set->addr_slots = table;
+    set->addr_mask = slots - 1;
+    for (uint32_t e = 0; e < set->addr_count; e++) {
+        size_t i = addr_slot_of(set, set->addrs[e].key);
+        while (table[i]) i = (i + 1) & set->addr_mask;
+        table[i] = e + 1;
+    }
+    return 1;
+}
+
+// һ½ַĿ
+static AddrEntry* addr_get(UTXOSet* set, const unsigned char key[20]) {
+    AddrEntry* a = addr_find(set, key);
+    if (a) return a;
+
+    if (set->addr_count == set->addr_cap) {
+        uint32_t cap = set->addr_cap ? set->addr_cap * 2 : 16;
+        AddrEntry* addrs = realloc(set->addrs, cap * sizeof(AddrEntry));
+        if (!addrs) return NULL;
+        set->addrs = addrs;
+        set->addr_cap = cap;
+    }
+    // װʲ 1/2
+    if (!set->addr_slots || (size_t)(set->addr_count + 1) * 2 > set->addr_mask + 1)
+        if (!addr_slots_grow(set)) return NULL;
+
+    a = &set->addrs[set->addr_count];
+    memset(a, 0, sizeof(*a));
+    memcpy(a->key, key, 20);
+
+    size_t i = addr_slot_of(set, key);
+    while (set->addr_slots[i]) i = (i + 1) & set->addr_mask;
+    set->addr_slots[i] = ++set->addr_count;
+    return a;
+}
+
+// ѱҹҵַ£u->hash160 Ѱ addr ãstandard Ϊ addr_key ķֵ
+static int addr_link(UTXOSet* set, UTXO* u, const char* addr, int standard) {
+    AddrEntry* a = addr_get(set, u->hash160);
+    if (!a) return 0;
+    if (!standard && !a->label && !(a->label = strdup(addr)))
+        return 0;
+
+    if (a->count == a->cap) {
+        uint32_t cap = a->cap ? a->cap * 2 : 4;
+        UTXO** coins = realloc(a->coins, cap * sizeof(UTXO*));
+        if (!coins) return 0;
+        a->coins = coins;
+        a->cap = cap;
+    }
+    u->owner_pos = a->count;
+    a->coins[a->count++] = u;
+    a->balance += u->amount;
+    return 1;
+}
+
+// ҵű e ̽
+static size_t addr_slot_find(const UTXOSet* set, uint32_t e) {
+    size_t i = addr_slot_of(set, set->addrs[e].key);
+    while (set->addr_slots[i] != e + 1) i = (i + 1) & set->addr_mask;
+    return i;
+}
+
+// ɾûбҵĵַĿ̽ƷɾĹĩβĿŲճı
+static void addr_remove(UTXOSet* set, AddrEntry* a) {
+    uint32_t e = (uint32_t)(a - set->addrs);
+    size_t hole = addr_slot_find(set, e);
+
+    // ͬһ̽ϵĲǰƣʼ۲ (hole, j] ֮ڵĲƵ hole
+    for (size_t j = (hole + 1) & set->addr_mask; set->addr_slots[j]; j = (j + 1) & set->addr_mask) {
+        size_t home = addr_slot_of(set, set->addrs[set->addr_slots[j] - 1].key);
+        if (((j - home) & set->addr_mask) >= ((j - hole) & set->addr_mask)) {
+            set->addr_slots[hole] = set->addr_slots[j];
+            hole = j;
+        }
+    }
+    set->addr_slots[hole] = 0;
+
+    free(a->coins);
+    free(a->label);
+
+    uint32_t last = --set->addr_count;
+    if (e != last) {
+        set->addr_slots[addr_slot_find(set, last)] = e + 1;
+        set->addrs[e] = set->addrs[last];
+    }
+}
+
+// ַժĩβıŲճλãַûб˾ɾĿ
+static void addr_unlink(UTXOSet* set, UTXO* u) {
+    AddrEntry* a = addr_find(set, u->hash160);
+    UTXO* last = a->coins[--a->count];
+    a->coins[u->owner_pos] = last;
+    last->owner_pos = u->owner_pos;
+    a->balance -= u->amount;
+    if (a->count == 0)
+        addr_remove(set, a);
+}
+
+// ַȡĿ
+static const AddrEntry* addr_lookup(const UTXOSet* set, const char* addr) {
+    if (!set || !addr) return NULL;
+    unsigned char key[20];
+    addr_key(addr, key);
+    return addr_find(set, key);
+}
+
+// ¾ű
+static UTXO* set_find(const UTXOSet* set, const unsigned char txid[32], uint32_t index) {
+    uint64_t h = utxo_hash(set, txid, index);
+    int slot;
+    UtxoBucket* bk = table_find(&set->cur, h, txid, index, &slot);
+    if (!bk) bk = table_find(&set->old, h, txid, index, &slot);
+    return bk ? bk->items[slot] : NULL;
+}
+
+// Ӽϣַժһ¼ͷţҲ NULL
+static UTXO* set_take(UTXOSet* set, const unsigned char txid[32], uint32_t index) {
+    uint64_t h = utxo_hash(set, txid, index);
+    int slot;
+    UTXO* u = NULL;
+    UtxoBucket* bk = table_find(&set->cur, h, txid, index, &slot);
+    if (bk) u = table_erase(&set->cur, h, bk, slot);
+    else if ((bk = table_find(&set->old, h, txid, index, &slot)) != NULL)
+        u = table_erase(&set->old, h, bk, slot);
+
+    if (u) addr_unlink(set, u);
+    return u;
+}
+
 // ----UTXO----
-void add_utxo(UTXO** utxo_set, const unsigned char txid[32], uint32_t index, const char* addr, uint32_t amount) 
+void add_utxo(UTXOSet** utxo_set, const unsigned char txid[32], uint32_t index, const char* addr, uint32_t amount) 
 {
-    UTXO* node = malloc(sizeof(UTXO)+1);
+    if (!*utxo_set && !(*utxo_set = utxo_set_create())) return;
+    UTXOSet* set = *utxo_set;
+
+    migrate_buckets(set, UTXO_MIGRATE_STEP);
+    if (!ensure_room(set)) return;
+
+    // ͬһظʱ滻ɼ¼
+    record_free(set, set_take(set, txid, index));
+
+    UTXO* node = record_alloc(set);
 
     if (!node) return;
 
     memcpy(node->txid, txid, 32);
     node->output_index = index;
-    snprintf(node->addr, 128, "%s", addr); 
+    int standard = addr_key(addr, node->hash160);
     node->amount = amount;
 
-    node->next = *utxo_set;     // ½ڵҵͷ
-
-    *utxo_set = node;
+    if (!addr_link(set, node, addr, standard)) {
+        record_free(set, node);
+        return;
+    }
+    table_insert(&set->cur, utxo_hash(set, txid, index), node);
 }
 
-// ----ѯ----
-uint64_t get_balance(const UTXO* utxo_set, const char* addr) {
-    uint64_t sum = 0;
-    const UTXO* cur = utxo_set;
+// --------
+const UTXO* utxo_set_next(const UTXOSet* utxo_set, size_t* pos) {
+    if (!utxo_set) return NULL;
 
-    while (cur) {
-        //printf("cur=%s\n", cur->addr);
-        if (strcmp(cur->addr, addr) == 0) {
-            sum += cur->amount;
-            printf("amount=%d\n", cur->amount);
+    // Ⱦɱ±pos ۱
+    const UtxoTable* tables[2] = { &utxo_set->old, &utxo_set->cur };
+    size_t base = 0;
+    for (int k = 0; k < 2; k++) {
+        const UtxoTable* t = tables[k];
+        size_t slots = t->buckets ? (t->mask + 1) * UTXO_BUCKET_SLOTS : 0;
+        for (; *pos < base + slots; (*pos)++) {
+            size_t i = *pos - base;
+            const UtxoBucket* bk = &t->buckets[i / UTXO_BUCKET_SLOTS];
+            if (bk->tags[i % UTXO_BUCKET_SLOTS]) {
+                const UTXO* u = bk->items[i % UTXO_BUCKET_SLOTS];
+                (*pos)++;
+                return u;
+            }
         }
-        
-        cur = cur->next;
+        base += slots;
     }
-    return sum;
+    return NULL;
+}
+
+size_t utxo_set_size(const UTXOSet* utxo_set) {
+    return utxo_set ? utxo_set->cur.count + utxo_set->old.count : 0;
+}
+
+void utxo_set_free(UTXOSet* utxo_set) {
+    if (!utxo_set) return;
+
+    for (size_t i = 0; i < utxo_set->slab_count; i++)
+        free(utxo_set->slabs[i]);
+    free(utxo_set->slabs);
+
+    for (uint32_t e = 0; e < utxo_set->addr_count; e++) {
+        free(utxo_set->addrs[e].coins);
+        free(utxo_set->addrs[e].label);
+    }
+    free(utxo_set->addrs);
+    free(utxo_set->addr_slots);
+
+    free(utxo_set->cur.buckets);
+    free(utxo_set->old.buckets);
+    free(utxo_set);
+}
+
+// ----ԭַ----
+void utxo_get_addr(const UTXOSet* utxo_set, const UTXO* utxo, char* out, size_t outlen) {
+    const AddrEntry* a = utxo_set ? addr_find(utxo_set, utxo->hash160) : NULL;
+    if (a && a->label) {
+        snprintf(out, outlen, "%s", a->label);
+        return;
+    }
+
+    unsigned char payload[21];
+    payload[0] = UTXO_ADDR_VERSION;
+    memcpy(payload + 1, utxo->hash160, 20);
+    if (!base58check_encode(payload, sizeof(payload), out, outlen) && outlen)
+        out[0] = '\0';
+}
+
+// ----ѯ----
+uint64_t get_balance(const UTXOSet* utxo_set, const char* addr) {
+    const AddrEntry* a = addr_lookup(utxo_set, addr);
+    return a ? a->balance : 0;
 }
 
 // ----Ƿ----
-int has_sufficient_balance(const UTXO* utxo_set,
+int has_sufficient_balance(const UTXOSet* utxo_set,
     const char* from_addr,
     uint64_t amount)
 {
@@ -49,56 +526,35 @@ int has_sufficient_balance(const UTXO* utxo_set,
 }
 
 // ----ѯUTXO----
-UTXO* find_utxo(UTXO* utxo_set, const unsigned char txid[32], uint32_t index) 
+UTXO* find_utxo(UTXOSet* utxo_set, const unsigned char txid[32], uint32_t index) 
 {
-    UTXO* cur = utxo_set;
-
-    while (cur) {
-        if (memcmp(cur->txid, txid, 32) == 0 && 
-            cur->output_index == index) 
-        {
-            return cur;
-        }
-        cur = cur->next;
-    }
-    return NULL;
+    if (!utxo_set) return NULL;
+    return set_find(utxo_set, txid, index);
 }
 
 
 // ----ɾUTXO----
-void remove_utxo(UTXO** utxo_set, const unsigned char txid[32], uint32_t index) {
-    UTXO** cur = utxo_set;
-
-    //
-    while (*cur) {
-        if (memcmp((*cur)->txid, txid, 32) == 0 && (*cur)->output_index == index) 
-        {
-            // ҵڵ
-            UTXO* tmp = *cur;
-            *cur = (*cur)->next;//
-            free(tmp);
-            return;
-        }
-
+void remove_utxo(UTXOSet** utxo_set, const unsigned char txid[32], uint32_t index) {
+    if (!*utxo_set) return;
 
-        cur = &(*cur)->next;
-    }
+    migrate_buckets(*utxo_set, UTXO_MIGRATE_STEP);
+    record_free(*utxo_set, set_take(*utxo_set, txid, index));
 }
 
 //  UTXO 
-int update_utxo_set(UTXO** utxo_set, const Tx* tx, const unsigned char txid[32]) {
+int update_utxo_set(UTXOSet** utxo_set, const Tx* tx, const unsigned char txid[32]) {
     
     /* ---- Step 1: ɾ Inputs Ӧ UTXO ---- */
     for (uint32_t i = 0; i < tx->input_count; i++) 
     {
         TxIn* in = &tx->inputs[i];
 
-        UTXO* u = find_utxo(*utxo_set, in->txid, in->output_index);
+        UTXO* u = *utxo_set ? set_take(*utxo_set, in->txid, in->output_index) : NULL;
         if (!u) {
             printf("UTXO not found for input!\n");
             return 0; //  UTXO   Ч
         }
-        remove_utxo(utxo_set, in->txid, in->output_index);
+        record_free(*utxo_set, u);
     }
 
     /* ---- Step 2:  Outputs Ϊµ UTXO ---- */
@@ -113,41 +569,42 @@ int update_utxo_set(UTXO** utxo_set, const Tx* tx, const unsigned char txid[32])
 }
 
 // ----ӡUTXO----
-void print_utxo_set(const UTXO* utxo_set) {
-    const UTXO* cur = utxo_set;
+void print_utxo_set(const UTXOSet* utxo_set) {
+    size_t pos = 0;
+    const UTXO* cur;
     printf("UTXO set:\n");
-    while (cur) {
-        printf("  Addr=%s\n", cur->addr);
-        printf("  Amount=%u\n", cur->amount);
-        printf("  TxID=");
-        for (int i = 0; i < 32; i++) {
-            printf("%02X", cur->txid[i]);
-        }
-        printf("\n  Index=%u\n\n", cur->output_index);
-        cur = cur->next;
+    while ((cur = utxo_set_next(utxo_set, &pos)) != NULL) {
+        char txid_hex[65], addr[128];
+        hex_encode(cur->txid, 32, txid_hex);
+        utxo_get_addr(utxo_set, cur, addr, sizeof(addr));
+        printf("  Addr=%s\n  Amount=%u\n  TxID=%s\n  Index=%u\n\n",
+            addr, cur->amount, txid_hex, cur->output_index);
     }
 }
 
 // ----ѡ----
-int select_coins(const UTXO* utxo_set,
+int select_coins(const UTXOSet* utxo_set,
                  const char* addr, 
                  uint64_t amount, 
                  CoinSelection* result)
 {
     result->count = 0;
     result->total = 0;
-    const UTXO* cur = utxo_set;
 
-    while (cur) {
-        if (strcmp(cur->addr, addr) == 0) {
-            result->utxos[result->count++] = cur;
-            result->total += cur->amount;
+    // ֻõַԼı
+    const AddrEntry* a = addr_lookup(utxo_set, addr);
+    if (!a) return 0;
 
-            if (result->total >= amount) {
-                return 1;   
-            }
+    for (uint32_t i = 0; i < a->count; i++) {
+        if (result->count == (int)(sizeof(result->utxos) / sizeof(result->utxos[0])))
+            break;  // ռô
+        const UTXO* cur = a->coins[i];
+        result->utxos[result->count++] = cur;
+        result->total += cur->amount;
+
+        if (result->total >= amount) {
+            return 1;   
         }
-        cur = cur->next;
     }
 
     return 0; // ޷ѡ
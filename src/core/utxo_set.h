@@ -4,19 +4,24 @@
 #include <stdint.h>
 #include "core/transaction.h"
 
-// ----UTXOṹ----
+// ----UTXOṹһУ64 ֽڣӼڲ slab ----
+// ֻտַ hash160ַҪʱ utxo_get_addr ԭ
 typedef struct UTXONode {
     unsigned char txid[32];     // ID
     uint32_t output_index;      // 
     uint32_t amount;            // ׽
-    char addr[128];              // տַ
-    struct UTXONode* next;      // һڵ
+    unsigned char hash160[20];  // տַ hash160Ǳ׼ַΪ SHA256 ǰ 20 ֽڣ
+    uint32_t owner_pos;         // ַбеλãڲά
 } UTXO;
 
-/*typedef struct {
-    UTXO set[MAX_UTXOS];
-    size_t count;
-} UTXOSet;*/
+_Static_assert(sizeof(UTXO) == 64, "UTXO record must fit one cache line");
+
+// ----UTXO (txid, output_index) ΪĿѰַϣ----
+// ÿͰһУ6  + 16 λָƣʱ¾ű棬ÿɾ˳ἸͰ
+// ȫָʼΪ NULLһ add_utxo ʱUTXO ¼ַɾǰֲ
+// аַhash160Ķÿַıбɾͬ£
+// ѯѡֻõַԼı
+typedef struct UTXOSet UTXOSet;
 
 typedef struct {
     const UTXO* utxos[64];      // ռָ
@@ -26,30 +31,45 @@ typedef struct {
 
 //int Select_coins(const UTXO* utxo_set, const char* addr, uint64_t amount, CoinSelection* result);
 
-// ----ͷһµ UTXO ڵ----
-void add_utxo(UTXO** utxo_set, const unsigned char txid[32], uint32_t index, const char* addr, uint32_t amount);
+// ---- UTXO*utxo_set Ϊ NULL ʱȴϣ----
+void add_utxo(UTXOSet** utxo_set, const unsigned char txid[32], uint32_t index, const char* addr, uint32_t amount);
 
 
 // ---- UTXO----
-UTXO* find_utxo(UTXO* utxo_set, const unsigned char txid[32], uint32_t index);
+UTXO* find_utxo(UTXOSet* utxo_set, const unsigned char txid[32], uint32_t index);
 
 // ----Ƴ UTXO----
-void remove_utxo(UTXO** utxo_set, const unsigned char txid[32], uint32_t index);
+void remove_utxo(UTXOSet** utxo_set, const unsigned char txid[32], uint32_t index);
 
 // --- UTXO ----
-int update_utxo_set(UTXO** utxo_set, const Tx* tx, const unsigned char txid[32]);
+int update_utxo_set(UTXOSet** utxo_set, const Tx* tx, const unsigned char txid[32]);
 
 // ----ӡUTXOб----
-void print_utxo_set(const UTXO* utxo_set);
+void print_utxo_set(const UTXOSet* utxo_set);
 
 // ----ȷǷ㹻----
-int has_sufficient_balance(const UTXO* utxo_set, const char* from_addr, uint64_t amount);
+int has_sufficient_balance(const UTXOSet* utxo_set, const char* from_addr, uint64_t amount);
 
 // ----ѡ----
-int select_coins(const UTXO* utxo_set, const char* addr, uint64_t amount, CoinSelection* result);
+int select_coins(const UTXOSet* utxo_set, const char* addr, uint64_t amount, CoinSelection* result);
 
 // ----ѯ----
-uint64_t get_balance(const UTXO* utxo_set, const char* addr);
+uint64_t get_balance(const UTXOSet* utxo_set, const char* addr);
+
+// ----ַ -> ׼ַе hash160 UTXO.hash160 ֱӱȽ----
+void utxo_addr_key(const char* addr, unsigned char key[20]);
+
+// ----ԭ UTXO տַ----
+void utxo_get_addr(const UTXOSet* utxo_set, const UTXO* utxo, char* out, size_t outlen);
+
+// ----UTXO ----
+size_t utxo_set_size(const UTXOSet* utxo_set);
+
+// ----*pos  0 ʼηÿ UTXO귵 NULLڼ䲻Ҫɾ----
+const UTXO* utxo_set_next(const UTXOSet* utxo_set, size_t* pos);
+
+// ----ͷ----
+void utxo_set_free(UTXOSet* utxo_set);
 
 #endif
 
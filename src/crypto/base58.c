@@ -1,46 +1,114 @@
 #include "base58.h"
-#include "double_sha256.h"
+#include "hash.h"
 #include <string.h>
 #include <stdio.h>
 
 static const char* BASE58 = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
 
-//  Base58 
+// ---- 64 λ㣺ÿִ 10 λ Base5858^10 < 2^64----
+#define B58_LIMB        430804206899405824ULL   // 58^10
+#define B58_LIMB_DIGITS 10
+
+// ַ -> ֵǷַΪ -1
+static const int8_t B58_MAP[256] = {
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1, 0, 1, 2, 3, 4, 5, 6,  7, 8,-1,-1,-1,-1,-1,-1,
+    -1, 9,10,11,12,13,14,15, 16,-1,17,18,19,20,21,-1,
+    22,23,24,25,26,27,28,29, 30,31,32,-1,-1,-1,-1,-1,
+    -1,33,34,35,36,37,38,39, 40,41,42,43,-1,44,45,46,
+    47,48,49,50,51,52,53,54, 55,56,57,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+};
+
+// 58^kk = 0..10ʱһ鲻 10 λ
+static const uint64_t B58_POW[B58_LIMB_DIGITS + 1] = {
+    1ULL, 58ULL, 3364ULL, 195112ULL, 11316496ULL, 656356768ULL,
+    38068692544ULL, 2207984167552ULL, 128063081718016ULL,
+    7427658739644928ULL, 430804206899405824ULL,
+};
+
+// (hi:lo) / 58^10Ҫ hi < 58^10̱Ȼŵý 64 λ
+static inline uint64_t div_limb(uint64_t hi, uint64_t lo, uint64_t* rem) {
+#if defined(__x86_64__)
+    uint64_t q, r;
+    __asm__("divq %4" : "=a"(q), "=d"(r) : "a"(lo), "d"(hi), "r"(B58_LIMB));
+    *rem = r;
+    return q;
+#else
+    unsigned __int128 n = ((unsigned __int128)hi << 64) | lo;
+    *rem = (uint64_t)(n % B58_LIMB);
+    return (uint64_t)(n / B58_LIMB);
+#endif
+}
+
+// =====================================================
+// Base58 encode (raw)
+// =====================================================
+// 밴װ 64 λ֣ 58^10ÿ 10 λ Base58
 size_t base58_encode(const uint8_t* in, size_t inlen, char* out, size_t outlen) {
+    if (outlen == 0) return 0;
+
     size_t zeroes = 0;
     while (zeroes < inlen && in[zeroes] == 0) zeroes++;
 
-    size_t size = (inlen - zeroes) * 138 / 100 + 1; // log(256)/log(58)  1.38
-    uint8_t buf[size];
-    memset(buf, 0, size);
-
-    size_t j;
-    for (size_t i = zeroes; i < inlen; i++) {
-        int carry = in[i];
-        for (j = size; j-- > 0;) {
-            carry += 256 * buf[j];
-            buf[j] = carry % 58;
-            carry /= 58;
-        }
+    const uint8_t* p = in + zeroes;
+    size_t n = inlen - zeroes;
+    size_t nw = (n + 7) / 8;
+    uint64_t words[nw + 1];     // ˣwords[0] λ
+
+    // һֿܲ 8 ֽ
+    size_t head = n - (nw ? (nw - 1) * 8 : 0);
+    size_t pos = 0;
+    for (size_t i = 0; i < nw; i++) {
+        size_t take = (i == 0) ? head : 8;
+        uint64_t w = 0;
+        for (size_t k = 0; k < take; k++) w = (w << 8) | p[pos++];
+        words[i] = w;
     }
 
-    j = 0;
-    while (j < size && buf[j] == 0) j++;
+    // λǰÿ < 58^10
+    size_t max_limbs = n * 138 / 100 / B58_LIMB_DIGITS + 2; // log(256)/log(58)  1.38
+    uint64_t limbs[max_limbs];
+    size_t nl = 0;
 
-    size_t out_index = 0;
-    for (size_t i = 0; i < zeroes; i++) {
-        if (out_index >= outlen - 1) return 0;
-        out[out_index++] = '1';
+    size_t top = 0;
+    while (top < nw && words[top] == 0) top++;
+    while (top < nw) {
+        uint64_t rem = 0;
+        for (size_t i = top; i < nw; i++)
+            words[i] = div_limb(rem, words[i], &rem);
+        limbs[nl++] = rem;
+        while (top < nw && words[top] == 0) top++;
     }
 
-    for (; j < size; j++) {
-        if (out_index >= outlen - 1) return 0;
-        out[out_index++] = BASE58[buf[j]];
+    // ÿչ 10 λߵȥǰ 0
+    char digits[nl * B58_LIMB_DIGITS + 1];
+    size_t nd = 0;
+    for (size_t i = 0; i < nl; i++) {
+        uint64_t v = limbs[i];
+        if (i + 1 == nl) {
+            while (v) { digits[nd++] = BASE58[v % 58]; v /= 58; }
+        } else {
+            for (int k = 0; k < B58_LIMB_DIGITS; k++) { digits[nd++] = BASE58[v % 58]; v /= 58; }
+        }
     }
 
-    if (out_index >= outlen) return 0;
-    out[out_index] = '\0';
-    return out_index;
+    size_t total = zeroes + nd;
+    if (total >= outlen) return 0;
+
+    memset(out, '1', zeroes);
+    for (size_t i = 0; i < nd; i++) out[zeroes + i] = digits[nd - 1 - i];
+    out[total] = '\0';
+    return total;
 }
 
 // Base58Check 
@@ -50,7 +118,7 @@ size_t base58check_encode(const uint8_t* payload, size_t payload_len, char* out,
     memcpy(buf, payload, payload_len);
 
     uint8_t hash[32];
-    double_sha256(payload, payload_len, hash);
+    hash_sha256d(payload, payload_len, hash);
     memcpy(buf + payload_len, hash, 4); // ǰ4ֽΪ checksum
 
     return base58_encode(buf, payload_len + 4, out, outlen);
@@ -59,42 +127,61 @@ size_t base58check_encode(const uint8_t* payload, size_t payload_len, char* out,
 // =====================================================
 // Base58 decode (raw)
 // =====================================================
+// ȡֵÿ 10 ַϳһ < 58^10  58^k ۼӵС 64 λ
 int base58_decode(const char* in, uint8_t* out, size_t* out_len) {
     size_t len = strlen(in);
     size_t zeroes = 0;
 
-    // Count leading '1'
+    // ǰ '1' Ӧǰ 0 ֽ
     while (zeroes < len && in[zeroes] == '1') zeroes++;
 
-    size_t size = (len - zeroes) * 733 / 1000 + 1; // log(58)/log(256)  0.733
-    uint8_t buf[size];
-    memset(buf, 0, size);
+    size_t m = len - zeroes;
+    size_t nw = (m * 733 / 1000 + 1) / 8 + 2;   // log(58)/log(256)  0.733
+    uint64_t words[nw];                          // Сˣwords[0] λ
+    size_t used = 0;
 
-    for (size_t i = zeroes; i < len; i++) {
-        const char* p = strchr(BASE58, in[i]);
-        if (!p) return 0; // invalid char
-        int carry = p - BASE58;
+    const unsigned char* s = (const unsigned char*)in + zeroes;
+    size_t i = 0;
+    while (i < m) {
+        size_t k = m - i < B58_LIMB_DIGITS ? m - i : B58_LIMB_DIGITS;
+        uint64_t v = 0;
+        for (size_t j = 0; j < k; j++) {
+            int d = B58_MAP[s[i + j]];
+            if (d < 0) return 0; // invalid char
+            v = v * 58 + (uint64_t)d;
+        }
+        i += k;
 
-        for (int j = size - 1; j >= 0; j--) {
-            carry += 58 * buf[j];
-            buf[j] = carry % 256;
-            carry /= 256;
+        // words = words * 58^k + v
+        uint64_t mul = B58_POW[k];
+        uint64_t carry = v;
+        for (size_t w = 0; w < used; w++) {
+            unsigned __int128 t = (unsigned __int128)words[w] * mul + carry;
+            words[w] = (uint64_t)t;
+            carry = (uint64_t)(t >> 64);
+        }
+        if (carry) {
+            if (used == nw) return 0; // overflow
+            words[used++] = carry;
         }
-        if (carry != 0) return 0; // overflow
     }
 
-    // Skip leading zeroes in decoded buffer
-    size_t j = 0;
-    while (j < size && buf[j] == 0) j++;
+    // Чֽ
+    size_t nbytes = 0;
+    if (used) {
+        uint64_t topw = words[used - 1];
+        size_t b = 0;
+        while (topw) { b++; topw >>= 8; }
+        nbytes = (used - 1) * 8 + b;
+    }
 
-    size_t decoded_len = zeroes + (size - j);
+    size_t decoded_len = zeroes + nbytes;
     if (*out_len < decoded_len) return 0; // no enough space
 
-    // Write leading zeros
     memset(out, 0, zeroes);
-
-    // Copy rest
-    memcpy(out + zeroes, buf + j, size - j);
+    uint8_t* q = out + decoded_len;
+    for (size_t b = 0; b < nbytes; b++)
+        *--q = (uint8_t)(words[b / 8] >> (8 * (b % 8)));
 
     *out_len = decoded_len;
     return 1;
@@ -115,7 +202,7 @@ size_t base58check_decode(const char* input, uint8_t* payload_out, size_t payloa
 
     // Extract checksum
     uint8_t check1[32];
-    double_sha256(tmp, tmplen - 4, check1);
+    hash_sha256d(tmp, tmplen - 4, check1);
 
     if (memcmp(check1, tmp + tmplen - 4, 4) != 0) {
         return 0; // checksum mismatch
@@ -128,3 +215,166 @@ size_t base58check_decode(const char* input, uint8_t* payload_out, size_t payloa
     memcpy(payload_out, tmp, payload_len);
     return payload_len;
 }
+
+// =====================================================
+// ӿ
+// =====================================================
+// Уһ B58_BATCH  hash_sha256_batchnative Ϊ໺ SIMD
+#define B58_BATCH 64
+
+size_t base58_encode_batch(const uint8_t* in, size_t inlen, size_t count, char* out, size_t out_stride) {
+    size_t ok = 0;
+    for (size_t i = 0; i < count; i++) {
+        char* o = out + i * out_stride;
+        if (base58_encode(in + i * inlen, inlen, o, out_stride)) ok++;
+        else if (out_stride) o[0] = '\0';
+    }
+    return ok;
+}
+
+size_t base58check_encode_batch(const uint8_t* payloads, size_t payload_len, size_t count, char* out, size_t out_stride) {
+    if (payload_len + 4 > 128) {
+        for (size_t i = 0; i < count && out_stride; i++) out[i * out_stride] = '\0';
+        return 0;
+    }
+
+    size_t ok = 0;
+    uint8_t hash[B58_BATCH * 32];
+    uint8_t buf[128];
+    for (size_t i = 0; i < count; i += B58_BATCH) {
+        size_t n = count - i < B58_BATCH ? count - i : B58_BATCH;
+        const uint8_t* p = payloads + i * payload_len;
+
+        hash_sha256_batch(p, payload_len, n, hash);
+        hash_sha256_batch(hash, 32, n, hash);
+
+        for (size_t j = 0; j < n; j++) {
+            char* o = out + (i + j) * out_stride;
+            memcpy(buf, p + j * payload_len, payload_len);
+            memcpy(buf + payload_len, hash + 32 * j, 4);
+            if (base58_encode(buf, payload_len + 4, o, out_stride)) ok++;
+            else if (out_stride) o[0] = '\0';
+        }
+    }
+    return ok;
+}
+
+size_t base58check_decode_batch(const char* const* in, size_t count, uint8_t* payload_out, size_t payload_len, uint8_t* valid) {
+    if (payload_len + 4 > 128) {
+        memset(valid, 0, count);
+        return 0;
+    }
+
+    size_t ok = 0;
+    uint8_t raw[B58_BATCH * 128];
+    uint8_t hash[B58_BATCH * 32];
+    for (size_t i = 0; i < count; i += B58_BATCH) {
+        size_t n = count - i < B58_BATCH ? count - i : B58_BATCH;
+        size_t rawlen = payload_len + 4;
+
+        // 루ȲԵֱЧٰУһ
+        for (size_t j = 0; j < n; j++) {
+            size_t l = 128;
+            uint8_t tmp[128];
+            valid[i + j] = in[i + j] && base58_decode(in[i + j], tmp, &l) && l == rawlen;
+            if (valid[i + j]) memcpy(raw + j * rawlen, tmp, rawlen);
+            else memset(raw + j * rawlen, 0, rawlen);
+        }
+
+        uint8_t packed[B58_BATCH * 124];
+        for (size_t j = 0; j < n; j++) memcpy(packed + j * payload_len, raw + j * rawlen, payload_len);
+        hash_sha256_batch(packed, payload_len, n, hash);
+        hash_sha256_batch(hash, 32, n, hash);
+
+        for (size_t j = 0; j < n; j++) {
+            uint8_t* dst = payload_out + (i + j) * payload_len;
+            if (valid[i + j] && memcmp(hash + 32 * j, raw + j * rawlen + payload_len, 4) == 0) {
+                memcpy(dst, packed + j * payload_len, payload_len);
+                ok++;
+            } else {
+                valid[i + j] = 0;
+                memset(dst, 0, payload_len);
+            }
+        }
+    }
+    return ok;
+}
+
+// =====================================================
+// Բ
+// =====================================================
+// /ǰ 0ȫ 0 64 λ֡ĸһ 25 ֽڵ 0xA1 汾ַ
+static const struct {
+    const char* bytes;
+    size_t len;
+    const char* text;
+} B58_VECTORS[] = {
+    { "\x61", 1,
+      "2g" },
+    { "\x62\x62\x62", 3,
+      "a3gV" },
+    { "\x00\xeb\x15\x23\x1d\xfc\xeb\x60\x92\x58\x86\xb6\x7d\x06\x52\x99"
+      "\x92\x59\x15\xae\xb1\x72\xc0\x66\x47", 25,
+      "1NS17iag9jJgTHD1VXjvLCEnZuQ3rJDE9L" },
+    { "\x00\x00\x28\x7f\xb4\xcd", 6,
+      "11233QC4" },
+    { "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00", 10,
+      "1111111111" },
+    { "\x00\x01\x11\xd3\x8e\x5f\xc9\x07\x1f\xfc\xd2\x0b\x4a\x76\x3c\xc9"
+      "\xae\x4f\x25\x2b\xb4\xe4\x8f\xd6\x6a\x83\x5e\x25\x2a\xda\x93\xff"
+      "\x48\x0d\x6d\xd4\x3d\xc6\x2a\x64\x11\x55\xa5", 43,
+      "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz" },
+    { "\xa1\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1a\x1b\x1c\x1d\x1e"
+      "\x1f\x20\x21\x22\x23\xca\xe1\x2a\x4a", 25,
+      "27ot4ne1tWHUrCNS1CvJmHGTFLuuuDFuFX7" },
+};
+
+#define B58_VECTOR_COUNT (sizeof(B58_VECTORS) / sizeof(B58_VECTORS[0]))
+#define B58_ADDR_PAYLOAD 21     // 汾 + hash160
+#define B58_TEST_ADDRS   3
+
+int base58_selftest(void) {
+    char text[128];
+    uint8_t bytes[128];
+    for (size_t v = 0; v < B58_VECTOR_COUNT; v++) {
+        size_t n = base58_encode((const uint8_t*)B58_VECTORS[v].bytes, B58_VECTORS[v].len, text, sizeof(text));
+        if (n != strlen(B58_VECTORS[v].text) || strcmp(text, B58_VECTORS[v].text) != 0) return 0;
+
+        n = sizeof(bytes);
+        if (!base58_decode(B58_VECTORS[v].text, bytes, &n)) return 0;
+        if (n != B58_VECTORS[v].len || memcmp(bytes, B58_VECTORS[v].bytes, n) != 0) return 0;
+    }
+
+    // Base58CheckַȥУ payloadӿһ£ĻһַҪЧ
+    const char* addr = B58_VECTORS[B58_VECTOR_COUNT - 1].text;
+    uint8_t payloads[B58_TEST_ADDRS * B58_ADDR_PAYLOAD];
+    for (int i = 0; i < B58_TEST_ADDRS; i++) {
+        memcpy(payloads + i * B58_ADDR_PAYLOAD, B58_VECTORS[B58_VECTOR_COUNT - 1].bytes, B58_ADDR_PAYLOAD);
+        payloads[i * B58_ADDR_PAYLOAD + B58_ADDR_PAYLOAD - 1] ^= (uint8_t)i;
+    }
+
+    char addrs[B58_TEST_ADDRS][40];
+    if (base58check_encode_batch(payloads, B58_ADDR_PAYLOAD, B58_TEST_ADDRS, addrs[0], sizeof(addrs[0])) != B58_TEST_ADDRS)
+        return 0;
+    if (strcmp(addrs[0], addr) != 0) return 0;
+    for (int i = 0; i < B58_TEST_ADDRS; i++) {
+        if (!base58check_encode(payloads + i * B58_ADDR_PAYLOAD, B58_ADDR_PAYLOAD, text, sizeof(text))) return 0;
+        if (strcmp(text, addrs[i]) != 0) return 0;
+    }
+
+    if (base58check_decode(addr, bytes, sizeof(bytes)) != B58_ADDR_PAYLOAD) return 0;
+    if (memcmp(bytes, payloads, B58_ADDR_PAYLOAD) != 0) return 0;
+
+    char* last = addrs[B58_TEST_ADDRS - 1];
+    last[5] = last[5] == '2' ? '3' : '2';
+    const char* in[B58_TEST_ADDRS];
+    for (int i = 0; i < B58_TEST_ADDRS; i++) in[i] = addrs[i];
+
+    uint8_t decoded[B58_TEST_ADDRS * B58_ADDR_PAYLOAD];
+    uint8_t valid[B58_TEST_ADDRS];
+    if (base58check_decode_batch(in, B58_TEST_ADDRS, decoded, B58_ADDR_PAYLOAD, valid) != B58_TEST_ADDRS - 1) return 0;
+    for (int i = 0; i < B58_TEST_ADDRS - 1; i++)
+        if (!valid[i]) return 0;
+    if (valid[B58_TEST_ADDRS - 1]) return 0;
+    return memcmp(decoded, payloads, (B58_TEST_ADDRS - 1) * B58_ADDR_PAYLOAD) == 0;
+}
@@ -2,8 +2,24 @@
 #include <stdint.h>
 #include <stddef.h>
 
+// 编码/解码都按 64 位字运算（每字 10 位 Base58），解码用 256 项查表
 size_t base58_encode(const uint8_t* in, size_t inlen, char* out, size_t outlen);
 size_t base58check_encode(const uint8_t* payload, size_t payload_len, char* out, size_t outlen);
 
 int base58_decode(const char* in, uint8_t* out, size_t* out_len);
-size_t base58check_decode(const char* in, uint8_t* payload_out, size_t payload_max_len);
\ No newline at end of file
+size_t base58check_decode(const char* in, uint8_t* payload_out, size_t payload_max_len);
+
+// ----批量接口：count 条等长输入，第 i 条结果写入 out + i*out_stride----
+// 返回成功条数；失败的一条输出空串
+size_t base58_encode_batch(const uint8_t* in, size_t inlen, size_t count, char* out, size_t out_stride);
+
+// 校验码走 sha256_batch（多缓冲 SIMD）一起算
+size_t base58check_encode_batch(const uint8_t* payloads, size_t payload_len, size_t count, char* out, size_t out_stride);
+
+// 解码 count 个地址，每个 payload 必须恰好 payload_len 字节，写入 payload_out + i*payload_len
+// valid[i] = 1 表示第 i 个合法（字符、长度、校验码都对），不合法的 payload 清零；返回合法个数
+size_t base58check_decode_batch(const char* const* in, size_t count, uint8_t* payload_out, size_t payload_len, uint8_t* valid);
+
+// 启动自测：已知向量的编码/解码往返（前导 0、全 0、0xA1 版本地址），Base58Check 批量与逐条一致
+// 全部通过返回 1
+int base58_selftest(void);
@@ -3,7 +3,7 @@
 
 #include <stddef.h>
 
-//----Base58Check ----
+//----Base58Check 루input ѴУ룬ʵּ base58.c----
 void Base58check_encode(const unsigned char* input, int len, char* out, int outlen);
 
 #endif
@@ -3,8 +3,13 @@
 #include "ripemd160.h"
 #include "base58.h"
 #include "double_sha256.h"
+#include "hash.h"
+#include "pubkey_cache.h"
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <secp256k1.h>
 #include <secp256k1_recovery.h>
 
@@ -13,10 +18,22 @@
 //  hash160 (SHA256 + RIPEMD160)
 void hash160(const uint8_t* data, size_t len, uint8_t out[20]) {
     uint8_t sha[32];
-    sha256(data, len, sha);
+    hash_sha256(data, len, sha);
     ripemd160(sha, 32, out);
 }
 
+//  hash160ֶм SHA256 ջ
+#define HASH160_BATCH_CHUNK 256
+
+void hash160_batch(const uint8_t* data, size_t len, size_t count, uint8_t* out) {
+    uint8_t sha[HASH160_BATCH_CHUNK * 32];
+    for (size_t i = 0; i < count; i += HASH160_BATCH_CHUNK) {
+        size_t n = count - i < HASH160_BATCH_CHUNK ? count - i : HASH160_BATCH_CHUNK;
+        hash_sha256_batch(data + i * len, len, n, sha);
+        ripemd160_batch(sha, 32, n, out + 20 * i);
+    }
+}
+
 // ԿתΪ P2PKH ַ
 void pubkey_to_address(const uint8_t pubkey[33], char out_address[BTC_ADDRESS_MAXLEN]) {
     uint8_t payload[21];
@@ -26,12 +43,36 @@ void pubkey_to_address(const uint8_t pubkey[33], char out_address[BTC_ADDRESS_MA
     base58check_encode(payload, 21, out_address, BTC_ADDRESS_MAXLEN);
 }
 
-static secp256k1_context* ctx = NULL;
+// ======================  secp256k1  =========================
+// ֻһΣ blindingŵ
+// ǩǩȽӿֻģ߳̿ͬʱʹãrandomize ֻڳʼʱһ
+static secp256k1_context* g_ctx = NULL;
+static pthread_once_t g_ctx_once = PTHREAD_ONCE_INIT;
 
-static void ensure_ctx() {
-    if (!ctx) {
-        ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+static void create_ctx(void) {
+    g_ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    if (!g_ctx) {
+        printf("[secp256k1] context create failed\n");
+        return;
     }
+
+    unsigned char seed[32];
+    int fd = open("/dev/urandom", O_RDONLY);
+    ssize_t n = fd >= 0 ? read(fd, seed, sizeof(seed)) : -1;
+    if (fd >= 0) close(fd);
+
+    if (n != (ssize_t)sizeof(seed) || !secp256k1_context_randomize(g_ctx, seed))
+        printf("[secp256k1] warning: context randomization failed\n");
+    memset(seed, 0, sizeof(seed));
+}
+
+void crypto_secp_init(void) {
+    pthread_once(&g_ctx_once, create_ctx);
+}
+
+secp256k1_context* crypto_secp_get_context(void) {
+    pthread_once(&g_ctx_once, create_ctx);
+    return g_ctx;
 }
 
 // ====================== ECDSA Sign =========================
@@ -40,7 +81,7 @@ int ecdsa_sign(const uint8_t privkey[32],
     const uint8_t hash32[32],
     uint8_t sig_out[72], size_t* sig_len)
 {
-    ensure_ctx();
+    secp256k1_context* ctx = crypto_secp_get_context();
 
     if (!privkey || !hash32 || !sig_out || !sig_len) {
         printf("ecdsa_sign error: NULL pointer input\n");
@@ -78,13 +119,13 @@ int ecdsa_verify(const uint8_t pubkey33[33],
     const uint8_t hash32[32],
     const uint8_t* sig, size_t sig_len)
 {
-    ensure_ctx();
+    secp256k1_context* ctx = crypto_secp_get_context();
 
     secp256k1_pubkey pubkey;
     secp256k1_ecdsa_signature signature;
 
-    // Կѹʽ 33 ֽڣ
-    if (!secp256k1_ec_pubkey_parse(ctx, &pubkey, pubkey33, 33)) {
+    // Կѹʽ 33 ֽڣԿ棩
+    if (!pubkey_cache_parse(pubkey33, 33, &pubkey)) {
         return 0;
     }
 
@@ -104,7 +145,7 @@ int ecdsa_verify(const uint8_t pubkey33[33],
 
 int ecdsa_get_pubkey(const uint8_t privkey[32], uint8_t pubkey33_out[33])
 {
-    ensure_ctx();
+    secp256k1_context* ctx = crypto_secp_get_context();
 
     secp256k1_pubkey pub;
 
@@ -123,25 +164,3 @@ int ecdsa_get_pubkey(const uint8_t privkey[32], uint8_t pubkey33_out[33])
 
     return 1;
 }
-
-static secp256k1_context* g_ctx = NULL;
-
-// ⲿûע contextڲ棨һʵ
-static secp256k1_context* get_ctx() {
-    if (g_ctx) return g_ctx;
-    g_ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
-    return g_ctx;
-}
-
-void crypto_secp_set_context(secp256k1_context* ctx) {
-    // ⲿ ctxʹڲ
-    if (g_ctx && ctx && g_ctx != ctx) {
-        // ڲ ctx滻ѡ
-        secp256k1_context_destroy(g_ctx);
-    }
-    g_ctx = ctx;
-}
-
-secp256k1_context* crypto_secp_get_context() {
-    return g_ctx ? g_ctx : get_ctx();
-}
\ No newline at end of file
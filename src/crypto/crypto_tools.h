@@ -24,6 +24,10 @@ void pubkey_to_address(const uint8_t pubkey[33], char out_address[BTC_ADDRESS_MA
 // ߺݼΪ hash160SHA256+RIPEMD160
 void hash160(const uint8_t* data, size_t len, uint8_t out[20]);
 
+//  hash160count ȳݣ count  33 ֽڹԿ i Ϊ data + i*lenд out + 20*i
+// ߶໺ SIMDsha256_batch + ripemd160_batch
+void hash160_batch(const uint8_t* data, size_t len, size_t count, uint8_t* out);
+
 // ECDSA ǩ˽ԿΪ 32 ֽڣ
 //  1=ɹ0=ʧ
 int ecdsa_sign(const uint8_t privkey[32],
@@ -39,8 +43,10 @@ int ecdsa_verify(const uint8_t pubkey[33],
 // ѹԿ33 ֽڣ
 int ecdsa_get_pubkey(const uint8_t privkey[32], uint8_t pubkey33_out[33]);
 
-void crypto_secp_set_context(secp256k1_context* ctx);
-secp256k1_context* crypto_secp_get_context();
+// Ψһ secp256k1 ģǩ + ǩһʹʱ
+// crypto_secp_init ʱǰãصĶ̹߳Ҫ
+void crypto_secp_init(void);
+secp256k1_context* crypto_secp_get_context(void);
 
 // ========== ݾɽӿڣwrapper ==========
 #define crypto_secp_sign      ecdsa_sign
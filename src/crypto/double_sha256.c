@@ -5,7 +5,11 @@
  *  sha256 һΣȻԽ sha256
  */
 void double_sha256(const uint8_t* data, size_t len, uint8_t out[32]) {
+    // Ĺ̶ֱרں
+    if (len == 32) { sha256d_32(data, out); return; }
+    if (len == 64) { sha256d_64(data, out); return; }
+
     uint8_t tmp[32];
     sha256(data, len, tmp);    // һ SHA256
-    sha256(tmp, 32, out);      // ڶ SHA256
+    sha256_32(tmp, out);       // ڶ SHA256̶ 32 ֽڣ
 }
@@ -0,0 +1,239 @@
+#include "crypto/hash.h"
+#include "crypto/sha256.h"
+#include "crypto/double_sha256.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+_Static_assert(sizeof(SHA256_CTX) <= HASH_STATE_SIZE, "HASH_STATE_SIZE too small for SHA256_CTX");
+
+extern const HashBackend hash_backend_openssl;
+
+// ----nativeԴʵ֣ѹ CPU ɣSHA-NI/AVX2/SSSE3----
+static void native_init(void* state) {
+    sha256_init((SHA256_CTX*)state);
+}
+
+static void native_update(void* state, const uint8_t* data, size_t len) {
+    sha256_update((SHA256_CTX*)state, data, len);
+}
+
+static void native_final(void* state, uint8_t out[32]) {
+    sha256_final((SHA256_CTX*)state, out);
+}
+
+static const HashBackend hash_backend_native = {
+    "native",
+    native_init,
+    native_update,
+    native_final,
+    sha256,
+    double_sha256,
+    sha256d_64_batch,
+    sha256_batch,
+};
+
+// ----refԴʵ̶֣ʹòοѹ----
+static void ref_init(void* state) {
+    sha256_init_ref((SHA256_CTX*)state);
+}
+
+static const HashBackend hash_backend_ref = {
+    "ref",
+    ref_init,
+    native_update,
+    native_final,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+};
+
+static const HashBackend* const g_backends[] = {
+    &hash_backend_native,
+    &hash_backend_openssl,
+    &hash_backend_ref,
+};
+#define BACKEND_COUNT (sizeof(g_backends) / sizeof(g_backends[0]))
+
+static const HashBackend* g_backend = &hash_backend_native;
+
+// ---- init/update/final ϳһԽӿ----
+static void backend_sha256(const HashBackend* be, const uint8_t* data, size_t len, uint8_t out[32]) {
+    if (be->sha256) {
+        be->sha256(data, len, out);
+        return;
+    }
+    _Alignas(16) unsigned char state[HASH_STATE_SIZE];
+    be->init(state);
+    be->update(state, data, len);
+    be->final(state, out);
+}
+
+static void backend_sha256d(const HashBackend* be, const uint8_t* data, size_t len, uint8_t out[32]) {
+    if (be->sha256d) {
+        be->sha256d(data, len, out);
+        return;
+    }
+    uint8_t tmp[32];
+    backend_sha256(be, data, len, tmp);
+    backend_sha256(be, tmp, 32, out);
+}
+
+static void backend_sha256d_64_batch(const HashBackend* be, const uint8_t* in, size_t count, uint8_t* out) {
+    if (be->sha256d_64_batch) {
+        be->sha256d_64_batch(in, count, out);
+        return;
+    }
+    // ˳ʱ i ֻѶ룬ԭؼ
+    for (size_t i = 0; i < count; i++)
+        backend_sha256d(be, in + 64 * i, 64, out + 32 * i);
+}
+
+static void backend_sha256_batch(const HashBackend* be, const uint8_t* data, size_t len, size_t count, uint8_t* out) {
+    if (be->sha256_batch) {
+        be->sha256_batch(data, len, count, out);
+        return;
+    }
+    // len >= 32 ʱ i ֻѶ룬ͬԭؼ
+    for (size_t i = 0; i < count; i++)
+        backend_sha256(be, data + len * i, len, out + 32 * i);
+}
+
+// =====================================================
+// ӿ
+// =====================================================
+void hash_init(HashCtx* ctx) {
+    ctx->backend = g_backend;
+    ctx->backend->init(ctx->state);
+}
+
+void hash_update(HashCtx* ctx, const void* data, size_t len) {
+    ctx->backend->update(ctx->state, (const uint8_t*)data, len);
+}
+
+void hash_final(HashCtx* ctx, uint8_t out[32]) {
+    ctx->backend->final(ctx->state, out);
+}
+
+void hash_sha256(const void* data, size_t len, uint8_t out[32]) {
+    backend_sha256(g_backend, (const uint8_t*)data, len, out);
+}
+
+void hash_sha256d(const void* data, size_t len, uint8_t out[32]) {
+    backend_sha256d(g_backend, (const uint8_t*)data, len, out);
+}
+
+void hash_sha256d_64_batch(const uint8_t* in, size_t count, uint8_t* out) {
+    backend_sha256d_64_batch(g_backend, in, count, out);
+}
+
+void hash_sha256_batch(const void* data, size_t len, size_t count, uint8_t* out) {
+    backend_sha256_batch(g_backend, (const uint8_t*)data, len, count, out);
+}
+
+int hash_backend_select(const char* name) {
+    for (size_t i = 0; i < BACKEND_COUNT; i++) {
+        if (strcmp(g_backends[i]->name, name) == 0) {
+            g_backend = g_backends[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+const char* hash_backend_name(void) {
+    return g_backend->name;
+}
+
+// =====================================================
+// Բ
+// =====================================================
+
+// SHA256("abc")
+static const uint8_t ABC_DIGEST[32] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+};
+
+#define BENCH_NODES 64
+#define BENCH_TX_LEN 160
+#define BENCH_ROUNDS 3
+
+// οʵһ£ѡ
+static int backend_selftest(const HashBackend* be, const uint8_t* data) {
+    uint8_t a[32], b[32];
+    backend_sha256(be, (const uint8_t*)"abc", 3, a);
+    if (memcmp(a, ABC_DIGEST, 32) != 0) return 0;
+
+    backend_sha256d(be, data, BENCH_TX_LEN, a);
+    backend_sha256d(&hash_backend_ref, data, BENCH_TX_LEN, b);
+    if (memcmp(a, b, 32) != 0) return 0;
+
+    uint8_t nodes[BENCH_NODES / 2 * 32];
+    backend_sha256d_64_batch(be, data, BENCH_NODES / 2, nodes);
+    backend_sha256d(&hash_backend_ref, data + 64 * 5, 64, b);
+    if (memcmp(nodes + 32 * 5, b, 32) != 0) return 0;
+
+    backend_sha256_batch(be, data, 33, BENCH_NODES / 2, nodes);
+    backend_sha256(&hash_backend_ref, data + 33 * 7, 33, b);
+    return memcmp(nodes + 32 * 7, b, 32) == 0;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ģȵ㣺һ merkle ڵ + ɱʷֶ update Ľ׹ϣ
+static double backend_bench(const HashBackend* be, const uint8_t* data) {
+    uint8_t nodes[BENCH_NODES * 64];
+    uint8_t out[32];
+    double best = 1e9;
+
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        memcpy(nodes, data, sizeof(nodes));
+        double t0 = now_seconds();
+
+        for (int k = 0; k < 16; k++)
+            backend_sha256d_64_batch(be, nodes, BENCH_NODES, nodes);
+
+        for (int k = 0; k < 256; k++) {
+            _Alignas(16) unsigned char state[HASH_STATE_SIZE];
+            be->init(state);
+            for (int off = 0; off < BENCH_TX_LEN; off += 40)
+                be->update(state, data + k + off, 40);
+            be->final(state, out);
+        }
+
+        double t = now_seconds() - t0;
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+const char* hash_backend_autoselect(void) {
+    uint8_t data[BENCH_NODES * 64 + 256];
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t)(i * 131 + 7);
+
+    const HashBackend* best = &hash_backend_native;
+    double best_time = 1e9;
+
+    for (size_t i = 0; i < BACKEND_COUNT; i++) {
+        const HashBackend* be = g_backends[i];
+        if (!backend_selftest(be, data)) {
+            printf("[Hash] backend %s failed self-test, skipped\n", be->name);
+            continue;
+        }
+        double t = backend_bench(be, data);
+        if (t < best_time) {
+            best_time = t;
+            best = be;
+        }
+    }
+
+    g_backend = best;
+    return g_backend->name;
+}
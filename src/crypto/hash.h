@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// =====================================================
+// ͳһ SHA-256 ڣ顢סǮBase58 
+// ˿ѡnativeԴ SHA-NI/SIMDopensslrefοʵ֣
+// =====================================================
+
+#define HASH_STATE_SIZE 128
+
+// --------
+typedef struct HashBackend {
+    const char* name;
+    void (*init)(void* state);
+    void (*update)(void* state, const uint8_t* data, size_t len);
+    void (*final)(void* state, uint8_t out[32]);
+
+    // ¿ѡΪ NULL ʱ init/update/final ʵ
+    void (*sha256)(const uint8_t* data, size_t len, uint8_t out[32]);
+    void (*sha256d)(const uint8_t* data, size_t len, uint8_t out[32]);
+    void (*sha256d_64_batch)(const uint8_t* in, size_t count, uint8_t* out);
+    void (*sha256_batch)(const uint8_t* data, size_t len, size_t count, uint8_t* out);
+} HashBackend;
+
+// ----ϣģջϷ䣬ͷţ----
+typedef struct {
+    const HashBackend* backend;
+    _Alignas(16) unsigned char state[HASH_STATE_SIZE];
+} HashCtx;
+
+void hash_init(HashCtx* ctx);
+void hash_update(HashCtx* ctx, const void* data, size_t len);
+void hash_final(HashCtx* ctx, uint8_t out[32]);
+
+// ----һԽӿ----
+void hash_sha256(const void* data, size_t len, uint8_t out[32]);
+void hash_sha256d(const void* data, size_t len, uint8_t out[32]);
+
+// count  64 ֽ˫ SHA256merkle ڵ㣩out  in ص
+void hash_sha256d_64_batch(const uint8_t* in, size_t count, uint8_t* out);
+
+// count ȳ SHA256 i Ϊ data + len*iд out + 32*i
+// len >= 32 ʱ out  data ص
+void hash_sha256_batch(const void* data, size_t len, size_t count, uint8_t* out);
+
+// ----ѡ----
+// ѡˣɹ 1
+int hash_backend_select(const char* name);
+
+// Բ⣺Уÿ˵Ľ٣ѡһ
+const char* hash_backend_autoselect(void);
+
+// ǰ
+const char* hash_backend_name(void);
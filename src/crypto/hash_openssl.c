@@ -0,0 +1,35 @@
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#include <openssl/sha.h>
+#include "crypto/hash.h"
+
+// OpenSSL ˣֱʹõͲ SHA256_CTXڵṩ״̬ EVP 
+// һ뵥Ԫ crypto/sha256.h  SHA256_CTX 
+
+_Static_assert(sizeof(SHA256_CTX) <= HASH_STATE_SIZE, "HASH_STATE_SIZE too small for OpenSSL SHA256_CTX");
+
+static void ossl_init(void* state) {
+    SHA256_Init((SHA256_CTX*)state);
+}
+
+static void ossl_update(void* state, const uint8_t* data, size_t len) {
+    SHA256_Update((SHA256_CTX*)state, data, len);
+}
+
+static void ossl_final(void* state, uint8_t out[32]) {
+    SHA256_Final(out, (SHA256_CTX*)state);
+}
+
+static void ossl_sha256(const uint8_t* data, size_t len, uint8_t out[32]) {
+    SHA256(data, len, out);
+}
+
+const HashBackend hash_backend_openssl = {
+    "openssl",
+    ossl_init,
+    ossl_update,
+    ossl_final,
+    ossl_sha256,
+    NULL,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,157 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#include "crypto/pubkey_cache.h"
+#include "crypto/crypto_tools.h"
+#include <secp256k1_recovery.h>
+
+// 256  x 8 · 2048 Կ
+#define CACHE_SETS      256
+#define CACHE_WAYS      8
+#define MAX_PUBKEY_LEN  65
+// ָĿļǩ 65 ֽ + ϣ 32 ֽ
+#define RECOVER_KEY_LEN (65 + 32)
+
+typedef struct {
+    unsigned char key[RECOVER_KEY_LEN];
+    unsigned char len;              // 0 ʾ
+    atomic_uchar referenced;        // clock λʱ 1
+    secp256k1_pubkey pub;
+} PubkeyEntry;
+
+typedef struct {
+    PubkeyEntry ways[CACHE_WAYS];
+    unsigned int hand;              // clock ָ룬дʹ
+} PubkeySet;
+
+static PubkeySet g_sets[CACHE_SETS];
+static pthread_rwlock_t g_lock = PTHREAD_RWLOCK_INITIALIZER;
+static atomic_uint_fast64_t g_hits;
+static atomic_uint_fast64_t g_misses;
+
+// Կ 1 ֽ֮ x ָ꣨Ŀǩ rƾȷֱֲȡֽΪ
+static PubkeySet* set_of(const unsigned char* input, size_t len)
+{
+    uint32_t h;
+    if (len >= 5)
+        memcpy(&h, input + 1, 4);
+    else
+        h = len ? input[0] : 0;
+    return &g_sets[h & (CACHE_SETS - 1)];
+}
+
+static PubkeyEntry* set_find(PubkeySet* s, const unsigned char* input, size_t len)
+{
+    for (int i = 0; i < CACHE_WAYS; i++) {
+        PubkeyEntry* e = &s->ways[i];
+        if (e->len == len && memcmp(e->key, input, len) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+static void cache_put(const unsigned char* key, size_t len, const secp256k1_pubkey* pub)
+{
+    PubkeySet* s = set_of(key, len);
+    pthread_rwlock_wrlock(&g_lock);
+
+    if (!set_find(s, key, len)) {
+        // clockλΪ 1 Ŀ㣩ѡеһΪ 0 
+        PubkeyEntry* victim;
+        while (1) {
+            victim = &s->ways[s->hand];
+            s->hand = (s->hand + 1) % CACHE_WAYS;
+            if (victim->len == 0 || !atomic_exchange(&victim->referenced, 0))
+                break;
+        }
+        memcpy(victim->key, key, len);
+        victim->len = (unsigned char)len;
+        victim->pub = *pub;
+        atomic_store(&victim->referenced, 0);
+    }
+
+    pthread_rwlock_unlock(&g_lock);
+}
+
+// з 1δɵ߼д
+static int cache_get(const unsigned char* key, size_t len, secp256k1_pubkey* out)
+{
+    PubkeySet* s = set_of(key, len);
+    pthread_rwlock_rdlock(&g_lock);
+    PubkeyEntry* e = set_find(s, key, len);
+    if (e) {
+        *out = e->pub;
+        atomic_store_explicit(&e->referenced, 1, memory_order_relaxed);
+    }
+    pthread_rwlock_unlock(&g_lock);
+
+    atomic_fetch_add_explicit(e ? &g_hits : &g_misses, 1, memory_order_relaxed);
+    return e != NULL;
+}
+
+void pubkey_cache_insert(const unsigned char* input, size_t len, const secp256k1_pubkey* pub)
+{
+    if (len == 0 || len > MAX_PUBKEY_LEN) return;
+    cache_put(input, len, pub);
+}
+
+int pubkey_cache_parse(const unsigned char* input, size_t len, secp256k1_pubkey* out)
+{
+    if (len == 0 || len > MAX_PUBKEY_LEN)
+        return 0;
+
+    if (cache_get(input, len, out))
+        return 1;
+
+    if (!secp256k1_ec_pubkey_parse(crypto_secp_get_context(), out, input, len))
+        return 0;
+
+    cache_put(input, len, out);
+    return 1;
+}
+
+int pubkey_cache_compress(const unsigned char* input, size_t len, unsigned char out[33])
+{
+    secp256k1_pubkey pub;
+    if (!pubkey_cache_parse(input, len, &pub))
+        return 0;
+
+    size_t outlen = 33;
+    return secp256k1_ec_pubkey_serialize(crypto_secp_get_context(), out, &outlen, &pub, SECP256K1_EC_COMPRESSED);
+}
+
+void pubkey_cache_insert_recovered(const unsigned char sig[65], const unsigned char hash[32],
+    const secp256k1_pubkey* pub)
+{
+    unsigned char key[RECOVER_KEY_LEN];
+    memcpy(key, sig, 65);
+    memcpy(key + 65, hash, 32);
+    cache_put(key, sizeof(key), pub);
+}
+
+int pubkey_cache_recover(const unsigned char sig[65], const unsigned char hash[32], secp256k1_pubkey* out)
+{
+    unsigned char key[RECOVER_KEY_LEN];
+    memcpy(key, sig, 65);
+    memcpy(key + 65, hash, 32);
+
+    if (cache_get(key, sizeof(key), out))
+        return 1;
+
+    secp256k1_context* ctx = crypto_secp_get_context();
+    secp256k1_ecdsa_recoverable_signature rsig;
+    if (sig[64] > 3 || !secp256k1_ecdsa_recoverable_signature_parse_compact(ctx, &rsig, sig, sig[64]))
+        return 0;
+    if (!secp256k1_ecdsa_recover(ctx, out, &rsig, hash))
+        return 0;
+
+    cache_put(key, sizeof(key), out);
+    return 1;
+}
+
+void pubkey_cache_stats(uint64_t* hits, uint64_t* misses)
+{
+    if (hits) *hits = atomic_load(&g_hits);
+    if (misses) *misses = atomic_load(&g_misses);
+}
@@ -0,0 +1,33 @@
+#ifndef PUBKEY_CACHE_H
+#define PUBKEY_CACHE_H
+#include <stddef.h>
+#include <stdint.h>
+#include <secp256k1.h>
+
+// ----ѽԿ----
+// лԿ33  65 ֽڣ-> secp256k1_pubkeyظ߼
+// ͬһűҲӿɻָǩָĹԿΪ ǩ(65) || Ϣϣ(32)
+//  + ÿһ clock ָ̭߳̿ͬʱѯ
+
+// Կֱӷػδе secp256k1_ec_pubkey_parse д뻺
+//  1=ɹ0=ԿЧЧԿ棩
+int pubkey_cache_parse(const unsigned char* input, size_t len, secp256k1_pubkey* out);
+
+//  33  65 ֽڹԿת 33 ֽѹʽ棩ԿЧ 0
+int pubkey_cache_compress(const unsigned char* input, size_t len, unsigned char out[33]);
+
+// дһ֪ЧĹԿǮԿã֮ǩֱУ
+void pubkey_cache_insert(const unsigned char* input, size_t len, const secp256k1_pubkey* pub);
+
+//  65 ֽڿɻָǩcompact + recidϢϣָԿ
+//  1=ɹǩԻָĹԿЧ0=ǩЧ
+int pubkey_cache_recover(const unsigned char sig[65], const unsigned char hash[32], secp256k1_pubkey* out);
+
+// дһ֪ (ǩ, ϣ) -> Կ ӳ䣨ǩã
+void pubkey_cache_insert_recovered(const unsigned char sig[65], const unsigned char hash[32],
+    const secp256k1_pubkey* pub);
+
+//  / δд
+void pubkey_cache_stats(uint64_t* hits, uint64_t* misses);
+
+#endif
@@ -2,14 +2,7 @@
 #include <string.h>
 #include <stdint.h>
 
-/*  RIPEMD160 ʵ֣ԹϿԴʵ */
-
-typedef struct {
-    uint32_t h[5];
-    uint8_t block[64];
-    uint64_t bitlen;
-    size_t blocklen;
-} RIPEMD160_CTX;
+/* RIPEMD160 ʵ֣໺ SIMD 汾 ripemd160_multi.c */
 
 #define ROTL(x,n) (((x) << (n)) | ((x) >> (32-(n))))
 #define F1(x,y,z) ((x) ^ (y) ^ (z))
@@ -32,7 +25,7 @@ static const uint8_t R[80] = {
 static const uint8_t RR[80] = {
   5,14,7,0,9,2,11,4,13,6,15,8,1,10,3,12,
   6,11,3,7,0,13,5,10,14,15,8,12,4,9,1,2,
-  15,5,1,3,7,14,6,9,11,8,12,2,10,0,13,4,
+  15,5,1,3,7,14,6,9,11,8,12,2,10,0,4,13,
   8,6,4,1,3,11,15,0,5,12,2,13,9,7,10,14,
   12,15,10,4,1,5,8,7,6,2,13,14,0,3,9,11
 };
@@ -53,69 +46,71 @@ static const uint8_t SS[80] = {
   8,5,12,9,12,5,14,6,8,13,6,5,15,13,11,11
 };
 
-static void ripemd160_transform(RIPEMD160_CTX* ctx, const uint8_t block[64]) {
+static uint32_t load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+//  j ֵĲΪ F1..F5Ϊ F5..F1
+static uint32_t round_f(int group, uint32_t x, uint32_t y, uint32_t z) {
+    switch (group) {
+    case 0:  return F1(x, y, z);
+    case 1:  return F2(x, y, z);
+    case 2:  return F3(x, y, z);
+    case 3:  return F4(x, y, z);
+    default: return F5(x, y, z);
+    }
+}
+
+void ripemd160_compress(uint32_t h[5], const uint8_t block[64]) {
     uint32_t a, b, c, d, e, aa, bb, cc, dd, ee, t;
     uint32_t x[16];
     int j;
 
     for (j = 0; j < 16; j++)
-        x[j] = block[j * 4] | (block[j * 4 + 1] << 8) | (block[j * 4 + 2] << 16) | (block[j * 4 + 3] << 24);
+        x[j] = load_le32(block + j * 4);
 
-    a = ctx->h[0]; b = ctx->h[1]; c = ctx->h[2]; d = ctx->h[3]; e = ctx->h[4];
+    a = h[0]; b = h[1]; c = h[2]; d = h[3]; e = h[4];
     aa = a; bb = b; cc = c; dd = d; ee = e;
 
     for (j = 0; j < 80; j++) {
-        t = ROTL(a + F1(b, c, d) + x[R[j]] + K[j / 16], S[j]) + e; a = e; e = d; d = ROTL(c, 10); c = b; b = t;
-        t = ROTL(aa + F5(bb, cc, dd) + x[RR[j]] + KK[j / 16], SS[j]) + ee; aa = ee; ee = dd; dd = ROTL(cc, 10); cc = bb; bb = t;
+        int g = j / 16;
+        t = ROTL(a + round_f(g, b, c, d) + x[R[j]] + K[g], S[j]) + e; a = e; e = d; d = ROTL(c, 10); c = b; b = t;
+        t = ROTL(aa + round_f(4 - g, bb, cc, dd) + x[RR[j]] + KK[g], SS[j]) + ee; aa = ee; ee = dd; dd = ROTL(cc, 10); cc = bb; bb = t;
     }
 
-    t = ctx->h[1] + c + dd;
-    ctx->h[1] = ctx->h[2] + d + ee;
-    ctx->h[2] = ctx->h[3] + e + aa;
-    ctx->h[3] = ctx->h[4] + a + bb;
-    ctx->h[4] = ctx->h[0] + b + cc;
-    ctx->h[0] = t;
+    t = h[1] + c + dd;
+    h[1] = h[2] + d + ee;
+    h[2] = h[3] + e + aa;
+    h[3] = h[4] + a + bb;
+    h[4] = h[0] + b + cc;
+    h[0] = t;
 }
 
 void ripemd160(const uint8_t* data, size_t len, uint8_t out[20]) {
-    RIPEMD160_CTX ctx;
-    ctx.h[0] = 0x67452301;
-    ctx.h[1] = 0xefcdab89;
-    ctx.h[2] = 0x98badcfe;
-    ctx.h[3] = 0x10325476;
-    ctx.h[4] = 0xc3d2e1f0;
-    ctx.bitlen = 0;
-    ctx.blocklen = 0;
-
-    size_t i;
-    for (i = 0; i < len; i++) {
-        ctx.block[ctx.blocklen++] = data[i];
-        if (ctx.blocklen == 64) {
-            ripemd160_transform(&ctx, ctx.block);
-            ctx.bitlen += 512;
-            ctx.blocklen = 0;
-        }
-    }
-
-    ctx.bitlen += ctx.blocklen * 8;
-    ctx.block[ctx.blocklen++] = 0x80;
-    if (ctx.blocklen > 56) {
-        while (ctx.blocklen < 64) ctx.block[ctx.blocklen++] = 0;
-        ripemd160_transform(&ctx, ctx.block);
-        ctx.blocklen = 0;
-    }
-    while (ctx.blocklen < 56) ctx.block[ctx.blocklen++] = 0;
-
-    uint64_t bl = ctx.bitlen;
-    for (i = 0; i < 8; i++)
-        ctx.block[ctx.blocklen++] = (bl >> (8 * i)) & 0xff;
-
-    ripemd160_transform(&ctx, ctx.block);
-
-    for (i = 0; i < 5; i++) {
-        out[i * 4] = ctx.h[i] & 0xff;
-        out[i * 4 + 1] = (ctx.h[i] >> 8) & 0xff;
-        out[i * 4 + 2] = (ctx.h[i] >> 16) & 0xff;
-        out[i * 4 + 3] = (ctx.h[i] >> 24) & 0xff;
+    uint32_t h[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+    // ֱӴѹֽڿ
+    size_t full = len / 64;
+    for (size_t i = 0; i < full; i++)
+        ripemd160_compress(h, data + i * 64);
+
+    // β + 0x80 +  + 64 λС˳ȣ 1  2 
+    uint8_t tail[128] = { 0 };
+    size_t rem = len - full * 64;
+    size_t tail_len = rem < 56 ? 64 : 128;
+    memcpy(tail, data + full * 64, rem);
+    tail[rem] = 0x80;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++)
+        tail[tail_len - 8 + i] = (uint8_t)(bits >> (8 * i));
+
+    for (size_t off = 0; off < tail_len; off += 64)
+        ripemd160_compress(h, tail + off);
+
+    for (int i = 0; i < 5; i++) {
+        out[i * 4] = h[i] & 0xff;
+        out[i * 4 + 1] = (h[i] >> 8) & 0xff;
+        out[i * 4 + 2] = (h[i] >> 16) & 0xff;
+        out[i * 4 + 3] = (h[i] >> 24) & 0xff;
     }
 }
@@ -3,3 +3,15 @@
 #include <stddef.h>
 
 void ripemd160(const uint8_t* data, size_t len, uint8_t out[20]);
+
+// 单块压缩（h 为 5 个字的链接状态）
+void ripemd160_compress(uint32_t h[5], const uint8_t block[64]);
+
+// 批量哈希 count 条等长的独立消息：第 i 条为 data + i*len，摘要写入 out + 20*i
+// 按 CPU 使用 16 (AVX-512) / 8 (AVX2) / 4 (SSE2) 通道并行，结果与 ripemd160() 逐位一致
+// len >= 20 时 out 可以与 data 重叠（原地计算）
+void ripemd160_batch(const uint8_t* data, size_t len, size_t count, uint8_t* out);
+
+// 启动自测：标量实现对已知答案向量，每种通道宽度再与标量逐位比较，不一致的宽度不再使用
+// 标量实现或整个批量接口出错返回 0
+int ripemd160_selftest(void);
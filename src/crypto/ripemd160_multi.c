@@ -0,0 +1,281 @@
+#include "ripemd160.h"
+#include "utils/cpu.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+// ----໺ RIPEMD-160N Ϣռһ SIMD ͨͬʱѹ----
+// ״̬Ϣ־ [][ͨ] Уͨ 4 (SSE2) / 8 (AVX2) / 16 (AVX-512)
+
+#define ROTL(x,n) (((x) << (n)) | ((x) >> (32-(n))))
+#define F1(x,y,z) ((x) ^ (y) ^ (z))
+#define F2(x,y,z) (((x)&(y)) | (~(x)&(z)))
+#define F3(x,y,z) (((x) | ~(y)) ^ (z))
+#define F4(x,y,z) (((x) & (z)) | ((y) & ~(z)))
+#define F5(x,y,z) ((x) ^ ((y) | ~(z)))
+
+#define MAX_LANES 16
+
+static const uint32_t K[5] = { 0x00000000,0x5a827999,0x6ed9eba1,0x8f1bbcdc,0xa953fd4e };
+static const uint32_t KK[5] = { 0x50a28be6,0x5c4dd124,0x6d703ef3,0x7a6d76e9,0x00000000 };
+
+static const uint8_t R[80] = {
+  0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+  7,4,13,1,10,6,15,3,12,0,9,5,2,14,11,8,
+  3,10,14,4,9,15,8,1,2,7,0,6,13,11,5,12,
+  1,9,11,10,0,8,12,4,13,3,7,15,14,5,6,2,
+  4,0,5,9,7,12,2,10,14,1,3,8,11,6,15,13
+};
+
+static const uint8_t RR[80] = {
+  5,14,7,0,9,2,11,4,13,6,15,8,1,10,3,12,
+  6,11,3,7,0,13,5,10,14,15,8,12,4,9,1,2,
+  15,5,1,3,7,14,6,9,11,8,12,2,10,0,4,13,
+  8,6,4,1,3,11,15,0,5,12,2,13,9,7,10,14,
+  12,15,10,4,1,5,8,7,6,2,13,14,0,3,9,11
+};
+
+static const uint8_t S[80] = {
+  11,14,15,12,5,8,7,9,11,13,14,15,6,7,9,8,
+  7,6,8,13,11,9,7,15,7,12,15,9,11,7,13,12,
+  11,13,6,7,14,9,13,15,14,8,13,6,5,12,7,5,
+  11,12,14,15,14,15,9,8,9,14,5,6,8,6,5,12,
+  9,15,5,11,6,8,13,12,5,12,13,14,11,8,5,6
+};
+
+static const uint8_t SS[80] = {
+  8,9,9,11,13,15,15,5,7,7,8,11,14,14,12,6,
+  9,13,15,7,12,8,9,11,7,7,12,7,6,15,13,11,
+  9,7,15,11,8,6,6,14,12,13,5,14,13,13,7,5,
+  15,5,8,11,14,14,6,14,6,9,12,9,12,5,15,8,
+  8,5,12,9,12,5,14,6,8,13,6,5,15,13,11,11
+};
+
+static const uint32_t IV[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+// state[5*N]w[16*N]һѹ N ͨһ 64 ֽڿ
+typedef void (*ripemd160_lanes_fn)(uint32_t* state, const uint32_t* w);
+
+// һ 16 ֣ fl frg Ϊ
+#define RMD_GROUP(fl, fr, g)                                                    \
+    _Pragma("GCC unroll 16")                                                    \
+    for (j = 16 * (g); j < 16 * (g) + 16; j++) {                                \
+        t = ROTL(a + fl(b, c, d) + m[R[j]] + K[g], S[j]) + e;                   \
+        a = e; e = d; d = ROTL(c, 10); c = b; b = t;                            \
+        t = ROTL(aa + fr(bb, cc, dd) + m[RR[j]] + KK[g], SS[j]) + ee;           \
+        aa = ee; ee = dd; dd = ROTL(cc, 10); cc = bb; bb = t;                   \
+    }
+
+//  GCC չдһֺͬȺ target ʵһ
+#define RIPEMD160_DEFINE_LANES(name, vec, lanes, tgt)                           \
+typedef uint32_t vec __attribute__((vector_size(4 * (lanes))));                 \
+__attribute__((target(tgt)))                                                    \
+static void name(uint32_t* state, const uint32_t* w) {                          \
+    vec s[5], m[16], a, b, c, d, e, aa, bb, cc, dd, ee, t;                      \
+    int j;                                                                      \
+    memcpy(s, state, sizeof(s));                                                \
+    memcpy(m, w, sizeof(m));                                                    \
+    a = aa = s[0]; b = bb = s[1]; c = cc = s[2]; d = dd = s[3]; e = ee = s[4];  \
+    RMD_GROUP(F1, F5, 0)                                                        \
+    RMD_GROUP(F2, F4, 1)                                                        \
+    RMD_GROUP(F3, F3, 2)                                                        \
+    RMD_GROUP(F4, F2, 3)                                                        \
+    RMD_GROUP(F5, F1, 4)                                                        \
+    t = s[1] + c + dd;                                                          \
+    s[1] = s[2] + d + ee;                                                       \
+    s[2] = s[3] + e + aa;                                                       \
+    s[3] = s[4] + a + bb;                                                       \
+    s[4] = s[0] + b + cc;                                                       \
+    s[0] = t;                                                                   \
+    memcpy(state, s, sizeof(s));                                                \
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+RIPEMD160_DEFINE_LANES(ripemd160_lanes_x4, v4u32, 4, "sse2")
+RIPEMD160_DEFINE_LANES(ripemd160_lanes_x8, v8u32, 8, "avx2")
+RIPEMD160_DEFINE_LANES(ripemd160_lanes_x16, v16u32, 16, "avx512f")
+#endif
+
+static uint32_t load_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+//  N ͨԵ 64 ֽڿתΪ [][ͨ]
+static void load_block_words(uint32_t* w, const uint8_t* const* blocks, int lanes) {
+    for (int j = 0; j < 16; j++)
+        for (int l = 0; l < lanes; l++)
+            w[j * lanes + l] = load_le32(blocks[l] + 4 * j);
+}
+
+// ----һ lanes ȳϢ RIPEMD-160䣩----
+// ȶȫд len >= 20 ʱ out  data ԭص
+static void ripemd160_lanes_group(ripemd160_lanes_fn fn, int lanes,
+    const uint8_t* data, size_t len, uint8_t* out)
+{
+    uint32_t state[5 * MAX_LANES];
+    uint32_t w[16 * MAX_LANES];
+    uint8_t tail[MAX_LANES][128];
+    const uint8_t* blocks[MAX_LANES];
+
+    for (int j = 0; j < 5; j++)
+        for (int l = 0; l < lanes; l++)
+            state[j * lanes + l] = IV[j];
+
+    size_t full = len / 64;
+    for (size_t b = 0; b < full; b++) {
+        for (int l = 0; l < lanes; l++)
+            blocks[l] = data + (size_t)l * len + b * 64;
+        load_block_words(w, blocks, lanes);
+        fn(state, w);
+    }
+
+    // β + 0x80 +  + 64 λС˳ȣ 1  2 
+    size_t rem = len - full * 64;
+    size_t tail_len = rem < 56 ? 64 : 128;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int l = 0; l < lanes; l++) {
+        memset(tail[l], 0, tail_len);
+        memcpy(tail[l], data + (size_t)l * len + full * 64, rem);
+        tail[l][rem] = 0x80;
+        for (int k = 0; k < 8; k++)
+            tail[l][tail_len - 8 + k] = (uint8_t)(bits >> (8 * k));
+    }
+    for (size_t off = 0; off < tail_len; off += 64) {
+        for (int l = 0; l < lanes; l++)
+            blocks[l] = tail[l] + off;
+        load_block_words(w, blocks, lanes);
+        fn(state, w);
+    }
+
+    for (int l = 0; l < lanes; l++) {
+        uint8_t* o = out + 20 * (size_t)l;
+        for (int j = 0; j < 5; j++) {
+            uint32_t v = state[j * lanes + l];
+            o[4 * j] = (uint8_t)v;
+            o[4 * j + 1] = (uint8_t)(v >> 8);
+            o[4 * j + 2] = (uint8_t)(v >> 16);
+            o[4 * j + 3] = (uint8_t)(v >> 24);
+        }
+    }
+}
+
+// ---- CPU ѡõͨȣӿխ----
+typedef struct {
+    ripemd160_lanes_fn fn;
+    int lanes;
+} LaneKernel;
+
+static LaneKernel g_kernels[3];
+static int g_kernel_count = 0;
+static pthread_once_t g_kernels_once = PTHREAD_ONCE_INIT;
+
+static void select_kernels(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    const CpuFeatures* cpu = cpu_features();
+    if (cpu->avx512f)
+        g_kernels[g_kernel_count++] = (LaneKernel){ ripemd160_lanes_x16, 16 };
+    if (cpu->avx2)
+        g_kernels[g_kernel_count++] = (LaneKernel){ ripemd160_lanes_x8, 8 };
+    g_kernels[g_kernel_count++] = (LaneKernel){ ripemd160_lanes_x4, 4 };
+#endif
+}
+
+// ----ϣ----
+void ripemd160_batch(const uint8_t* data, size_t len, size_t count, uint8_t* out) {
+    pthread_once(&g_kernels_once, select_kernels);
+
+    size_t i = 0;
+    for (int k = 0; k < g_kernel_count; k++) {
+        size_t lanes = (size_t)g_kernels[k].lanes;
+        for (; count - i >= lanes; i += lanes)
+            ripemd160_lanes_group(g_kernels[k].fn, (int)lanes, data + i * len, len, out + 20 * i);
+    }
+
+    // ˣͨλһ
+    for (; i < count; i++)
+        ripemd160(data + i * len, len, out + 20 * i);
+}
+
+// ----Բ----
+// ֪մϢ56 ֽڣռ飩 80 ֽڣ飩
+static const struct {
+    const char* msg;
+    uint8_t digest[20];
+} KNOWN_ANSWERS[] = {
+    { "",
+      { 0x9c, 0x11, 0x85, 0xa5, 0xc5, 0xe9, 0xfc, 0x54, 0x61, 0x28, 0x08, 0x97, 0x7e, 0xe8, 0xf5, 0x48, 0xb2, 0x25, 0x8d, 0x31 } },
+    { "abc",
+      { 0x8e, 0xb2, 0x08, 0xf7, 0xe0, 0x5d, 0x98, 0x7a, 0x9b, 0x04, 0x4a, 0x8e, 0x98, 0xc6, 0xb0, 0x87, 0xf1, 0x5a, 0x0b, 0xfc } },
+    { "message digest",
+      { 0x5d, 0x06, 0x89, 0xef, 0x49, 0xd2, 0xfa, 0xe5, 0x72, 0xb8, 0x81, 0xb1, 0x23, 0xa8, 0x5f, 0xfa, 0x21, 0x59, 0x5f, 0x36 } },
+    { "abcdefghijklmnopqrstuvwxyz",
+      { 0xf7, 0x1c, 0x27, 0x10, 0x9c, 0x69, 0x2c, 0x1b, 0x56, 0xbb, 0xdc, 0xeb, 0x5b, 0x9d, 0x28, 0x65, 0xb3, 0x70, 0x8d, 0xbc } },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+      { 0x12, 0xa0, 0x53, 0x38, 0x4a, 0x9c, 0x0c, 0x88, 0xe4, 0x05, 0xa0, 0x6c, 0x27, 0xdc, 0xf4, 0x9a, 0xda, 0x62, 0xeb, 0x2b } },
+    { "1234567890123456789012345678901234567890"
+      "1234567890123456789012345678901234567890",
+      { 0x9b, 0x75, 0x2e, 0x45, 0x57, 0x3d, 0x4b, 0x39, 0xf4, 0xdb, 0xd3, 0x32, 0x3c, 0xab, 0x82, 0xbf, 0x63, 0x32, 0x6b, 0xfb } },
+};
+
+#define KNOWN_ANSWER_COUNT (sizeof(KNOWN_ANSWERS) / sizeof(KNOWN_ANSWERS[0]))
+
+// ÿ֪Ƶͨͨ˶ԣøͨݲͬϢȽ
+static int lanes_selftest(const LaneKernel* k) {
+    static const size_t lens[] = { 20, 33, 55, 56, 63, 64, 65, 119, 128 };
+    uint8_t data[MAX_LANES * 128];
+    uint8_t out[MAX_LANES * 20];
+    uint8_t ref[20];
+
+    for (size_t v = 0; v < KNOWN_ANSWER_COUNT; v++) {
+        size_t len = strlen(KNOWN_ANSWERS[v].msg);
+        for (int l = 0; l < k->lanes; l++)
+            memcpy(data + (size_t)l * len, KNOWN_ANSWERS[v].msg, len);
+        ripemd160_lanes_group(k->fn, k->lanes, data, len, out);
+        for (int l = 0; l < k->lanes; l++)
+            if (memcmp(out + 20 * l, KNOWN_ANSWERS[v].digest, 20) != 0) return 0;
+    }
+
+    for (size_t n = 0; n < sizeof(lens) / sizeof(lens[0]); n++) {
+        size_t len = lens[n];
+        for (size_t i = 0; i < len * (size_t)k->lanes; i++)
+            data[i] = (uint8_t)(i * 167 + len);
+        ripemd160_lanes_group(k->fn, k->lanes, data, len, out);
+        for (int l = 0; l < k->lanes; l++) {
+            ripemd160(data + (size_t)l * len, len, ref);
+            if (memcmp(out + 20 * l, ref, 20) != 0) return 0;
+        }
+    }
+    return 1;
+}
+
+int ripemd160_selftest(void) {
+    pthread_once(&g_kernels_once, select_kernels);
+
+    uint8_t out[20];
+    for (size_t v = 0; v < KNOWN_ANSWER_COUNT; v++) {
+        ripemd160((const uint8_t*)KNOWN_ANSWERS[v].msg, strlen(KNOWN_ANSWERS[v].msg), out);
+        if (memcmp(out, KNOWN_ANSWERS[v].digest, 20) != 0) return 0;
+    }
+
+    // һµͨȲʹãӿ˵խں˻
+    int kept = 0;
+    for (int k = 0; k < g_kernel_count; k++) {
+        if (lanes_selftest(&g_kernels[k]))
+            g_kernels[kept++] = g_kernels[k];
+        else
+            printf("[RIPEMD-160] %d-lane kernel failed self-test, skipped\n", g_kernels[k].lanes);
+    }
+    g_kernel_count = kept;
+
+    // ӿڣȷ + βһΣ31  33 ֽڹԿ
+    uint8_t keys[31 * 33];
+    uint8_t digests[31 * 20];
+    for (size_t i = 0; i < sizeof(keys); i++)
+        keys[i] = (uint8_t)(i * 29 + 3);
+    ripemd160_batch(keys, 33, 31, digests);
+    for (int i = 0; i < 31; i++) {
+        ripemd160(keys + 33 * i, 33, out);
+        if (memcmp(digests + 20 * i, out, 20) != 0) return 0;
+    }
+    return 1;
+}
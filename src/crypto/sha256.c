@@ -1,5 +1,14 @@
 #include "sha256.h"
+#include "utils/cpu.h"
 #include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SHA256_X86 1
+#else
+#define SHA256_X86 0
+#endif
 
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
 #define CH(x,y,z)     (((x) & (y)) ^ (~(x) & (z)))
@@ -20,60 +29,259 @@ static const uint32_t K[64] = {
     0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
 };
 
-static void sha256_transform(SHA256_CTX* ctx, const uint8_t data[64]) {
+static const uint32_t IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// ----固定长度消息的填充（编译期常量）----
+// 64 字节消息的第二块：0x80 + 补零 + 长度 512 bit
+static const uint8_t PAD_64[64] = { 0x80, [62] = 0x02 };
+// 32 字节消息所在块的后半部分：0x80 + 补零 + 长度 256 bit
+static const uint8_t PAD_32[32] = { 0x80, [30] = 0x01 };
+
+typedef void (*sha256_transform_fn)(uint32_t state[8], const uint8_t* data, size_t blocks);
+
+// ----参考实现（纯 C，所有平台可用）----
+static void sha256_transform_ref(uint32_t state[8], const uint8_t* data, size_t blocks) {
     uint32_t a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
 
-    for (i = 0, j = 0; i < 16; ++i, j += 4)
-        m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | (data[j + 3]);
+    while (blocks--) {
+        for (i = 0, j = 0; i < 16; ++i, j += 4)
+            m[i] = ((uint32_t)data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | (data[j + 3]);
+
+        for (; i < 64; ++i)
+            m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+
+        a = state[0]; b = state[1]; c = state[2]; d = state[3];
+        e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+        for (i = 0; i < 64; ++i) {
+            t1 = h + EP1(e) + CH(e, f, g) + K[i] + m[i];
+            t2 = EP0(a) + MAJ(a, b, c);
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        data += 64;
+    }
+}
+
+#if SHA256_X86
+
+// ----SSSE3 / AVX2 实现：消息扩展用 SIMD 一次算 4 个字，轮函数仍为标量----
+#define SSE_ROR(x, n) _mm_or_si128(_mm_srli_epi32((x), (n)), _mm_slli_epi32((x), 32 - (n)))
+#define SSE_SIG0(x)   _mm_xor_si128(_mm_xor_si128(SSE_ROR((x), 7), SSE_ROR((x), 18)), _mm_srli_epi32((x), 3))
+#define SSE_SIG1(x)   _mm_xor_si128(_mm_xor_si128(SSE_ROR((x), 17), SSE_ROR((x), 19)), _mm_srli_epi32((x), 10))
+
+// 同一份代码按不同 target 编译两次：AVX2+BMI2 版本会得到 VEX 编码与 rorx
+#define SHA256_DEFINE_SCHED_TRANSFORM(name, tgt)                                        \
+__attribute__((target(tgt)))                                                            \
+static void name(uint32_t state[8], const uint8_t* data, size_t blocks) {               \
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL); \
+    uint32_t wk[64] __attribute__((aligned(16)));                                       \
+    __m128i w[16];                                                                      \
+    uint32_t a, b, c, d, e, f, g, h, t1, t2;                                            \
+    int q, i;                                                                           \
+                                                                                        \
+    while (blocks--) {                                                                  \
+        for (q = 0; q < 4; q++)                                                         \
+            w[q] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * q)), bswap); \
+        for (q = 4; q < 16; q++) {                                                      \
+            __m128i t = _mm_add_epi32(w[q - 4], _mm_alignr_epi8(w[q - 1], w[q - 2], 4)); \
+            t = _mm_add_epi32(t, SSE_SIG0(_mm_alignr_epi8(w[q - 3], w[q - 4], 4)));     \
+            /* 低两个字依赖上一组的 W[t-2]，高两个字依赖本组刚算出的低两个字 */    \
+            t = _mm_add_epi32(t, SSE_SIG1(_mm_srli_si128(w[q - 1], 8)));                \
+            t = _mm_add_epi32(t, SSE_SIG1(_mm_slli_si128(t, 8)));                       \
+            w[q] = t;                                                                   \
+        }                                                                               \
+        for (q = 0; q < 16; q++)                                                        \
+            _mm_store_si128((__m128i*)(wk + 4 * q),                                     \
+                _mm_add_epi32(w[q], _mm_loadu_si128((const __m128i*)(K + 4 * q))));     \
+                                                                                        \
+        a = state[0]; b = state[1]; c = state[2]; d = state[3];                         \
+        e = state[4]; f = state[5]; g = state[6]; h = state[7];                         \
+        _Pragma("GCC unroll 8")                                                         \
+        for (i = 0; i < 64; ++i) {                                                      \
+            t1 = h + EP1(e) + CH(e, f, g) + wk[i];                                      \
+            t2 = EP0(a) + MAJ(a, b, c);                                                 \
+            h = g; g = f; f = e; e = d + t1;                                            \
+            d = c; c = b; b = a; a = t1 + t2;                                           \
+        }                                                                               \
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;                     \
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;                     \
+        data += 64;                                                                     \
+    }                                                                                   \
+}
+
+SHA256_DEFINE_SCHED_TRANSFORM(sha256_transform_ssse3, "ssse3")
+SHA256_DEFINE_SCHED_TRANSFORM(sha256_transform_avx2, "avx2,bmi2")
+
+// ----SHA-NI 实现：sha256rnds2 一条指令完成两轮----
+// a = msg2(msg1(a, b) + alignr(d, c), d)，即 W[t] = σ1(W[t-2]) + W[t-7] + σ0(W[t-15]) + W[t-16]
+#define SHANI_SCHED(a, b, c, d) \
+    a = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(a, b), _mm_alignr_epi8(d, c, 4)), d)
+
+#define SHANI_QROUND(msg, k) do {                                          \
+    __m128i t_ = _mm_add_epi32((msg), _mm_loadu_si128((const __m128i*)(k))); \
+    st1 = _mm_sha256rnds2_epu32(st1, st0, t_);                              \
+    t_ = _mm_shuffle_epi32(t_, 0x0E);                                       \
+    st0 = _mm_sha256rnds2_epu32(st0, st1, t_);                              \
+} while (0)
+
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha256_transform_shani(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i st0, st1, tmp, m0, m1, m2, m3, save0, save1;
 
-    for (; i < 64; ++i)
-        m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+    // state 由 ABCD/EFGH 重排为指令需要的 ABEF/CDGH
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1);
+    st1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B);
+    st0 = _mm_alignr_epi8(tmp, st1, 8);
+    st1 = _mm_blend_epi16(st1, tmp, 0xF0);
 
-    a = ctx->state[0]; b = ctx->state[1]; c = ctx->state[2]; d = ctx->state[3];
-    e = ctx->state[4]; f = ctx->state[5]; g = ctx->state[6]; h = ctx->state[7];
+    while (blocks--) {
+        save0 = st0;
+        save1 = st1;
 
-    for (i = 0; i < 64; ++i) {
-        t1 = h + EP1(e) + CH(e, f, g) + K[i] + m[i];
-        t2 = EP0(a) + MAJ(a, b, c);
+        m0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap);
+        m1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap);
+        m2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap);
+        m3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap);
+
+        SHANI_QROUND(m0, K + 0);
+        SHANI_QROUND(m1, K + 4);
+        SHANI_QROUND(m2, K + 8);
+        SHANI_QROUND(m3, K + 12);
+        for (int i = 16; i < 64; i += 16) {
+            SHANI_SCHED(m0, m1, m2, m3); SHANI_QROUND(m0, K + i);
+            SHANI_SCHED(m1, m2, m3, m0); SHANI_QROUND(m1, K + i + 4);
+            SHANI_SCHED(m2, m3, m0, m1); SHANI_QROUND(m2, K + i + 8);
+            SHANI_SCHED(m3, m0, m1, m2); SHANI_QROUND(m3, K + i + 12);
+        }
+
+        st0 = _mm_add_epi32(st0, save0);
+        st1 = _mm_add_epi32(st1, save1);
+        data += 64;
+    }
 
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
+    // 还原为 ABCD/EFGH
+    tmp = _mm_shuffle_epi32(st0, 0x1B);
+    st1 = _mm_shuffle_epi32(st1, 0xB1);
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, st1, 0xF0));
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(st1, tmp, 8));
+}
+
+#endif // SHA256_X86
+
+// ----运行时分派：启动时按 cpuid 选择一次----
+static void sha256_transform_detect(uint32_t state[8], const uint8_t* data, size_t blocks);
+
+static sha256_transform_fn sha256_transform_impl = sha256_transform_detect;
+static const char* sha256_transform_name = "ref";
+static pthread_once_t sha256_detect_once = PTHREAD_ONCE_INIT;
+
+static void sha256_select_transform(void) {
+    sha256_transform_fn fn = sha256_transform_ref;
+    const char* name = "ref";
+
+#if SHA256_X86
+    const CpuFeatures* cpu = cpu_features();
+    if (cpu->sha && cpu->sse41 && cpu->ssse3) {
+        fn = sha256_transform_shani;
+        name = "sha-ni";
+    }
+    else if (cpu->avx2 && cpu->bmi2) {
+        fn = sha256_transform_avx2;
+        name = "avx2";
+    }
+    else if (cpu->ssse3) {
+        fn = sha256_transform_ssse3;
+        name = "ssse3";
     }
+#endif
 
-    ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c; ctx->state[3] += d;
-    ctx->state[4] += e; ctx->state[5] += f; ctx->state[6] += g; ctx->state[7] += h;
+    sha256_transform_name = name;
+    sha256_transform_impl = fn;
+}
+
+void sha256_autodetect(void) {
+    pthread_once(&sha256_detect_once, sha256_select_transform);
+}
+
+const char* sha256_impl_name(void) {
+    sha256_autodetect();
+    return sha256_transform_name;
+}
+
+// 首次调用时完成检测，之后直接走选中的实现
+static void sha256_transform_detect(uint32_t state[8], const uint8_t* data, size_t blocks) {
+    sha256_autodetect();
+    sha256_transform_impl(state, data, blocks);
+}
+
+static void sha256_transform(SHA256_CTX* ctx, const uint8_t data[64]) {
+    ctx->transform(ctx->state, data, 1);
+}
+
+static void sha256_store_state(const uint32_t state[8], uint8_t out[32]) {
+    for (int i = 0; i < 8; i++) {
+        out[i * 4] = (state[i] >> 24) & 0xff;
+        out[i * 4 + 1] = (state[i] >> 16) & 0xff;
+        out[i * 4 + 2] = (state[i] >> 8) & 0xff;
+        out[i * 4 + 3] = state[i] & 0xff;
+    }
 }
 
 void sha256_init(SHA256_CTX* ctx) {
-    ctx->state[0] = 0x6a09e667;
-    ctx->state[1] = 0xbb67ae85;
-    ctx->state[2] = 0x3c6ef372;
-    ctx->state[3] = 0xa54ff53a;
-    ctx->state[4] = 0x510e527f;
-    ctx->state[5] = 0x9b05688c;
-    ctx->state[6] = 0x1f83d9ab;
-    ctx->state[7] = 0x5be0cd19;
+    memcpy(ctx->state, IV, sizeof(IV));
 
     ctx->bitlen = 0;
     ctx->buffer_len = 0;
+    ctx->transform = sha256_transform_impl;
+}
+
+// 固定使用参考实现，供哈希后端对比与自检
+void sha256_init_ref(SHA256_CTX* ctx) {
+    sha256_init(ctx);
+    ctx->transform = sha256_transform_ref;
 }
 
 void sha256_update(SHA256_CTX* ctx, const uint8_t* data, size_t len) {
-    for (size_t i = 0; i < len; i++) {
-        ctx->buffer[ctx->buffer_len++] = data[i];
+    // 先把上次剩下的不足一块的数据补满
+    if (ctx->buffer_len > 0) {
+        size_t n = 64 - ctx->buffer_len;
+        if (n > len) n = len;
+        memcpy(ctx->buffer + ctx->buffer_len, data, n);
+        ctx->buffer_len += n;
+        data += n;
+        len -= n;
 
-        if (ctx->buffer_len == 64) {
-            sha256_transform(ctx, ctx->buffer);
-            ctx->bitlen += 512;
-            ctx->buffer_len = 0;
-        }
+        if (ctx->buffer_len < 64) return;
+        sha256_transform(ctx, ctx->buffer);
+        ctx->bitlen += 512;
+        ctx->buffer_len = 0;
     }
+
+    // 整块直接从调用者内存压缩，不经过缓冲区
+    size_t blocks = len / 64;
+    if (blocks > 0) {
+        ctx->transform(ctx->state, data, blocks);
+        ctx->bitlen += (uint64_t)blocks * 512;
+        data += blocks * 64;
+        len -= blocks * 64;
+    }
+
+    memcpy(ctx->buffer, data, len);
+    ctx->buffer_len = len;
 }
 
 void sha256_final(SHA256_CTX* ctx, uint8_t out[32]) {
@@ -102,12 +310,7 @@ void sha256_final(SHA256_CTX* ctx, uint8_t out[32]) {
 
     sha256_transform(ctx, ctx->buffer);
 
-    for (i = 0; i < 8; i++) {
-        out[i * 4] = (ctx->state[i] >> 24) & 0xff;
-        out[i * 4 + 1] = (ctx->state[i] >> 16) & 0xff;
-        out[i * 4 + 2] = (ctx->state[i] >> 8) & 0xff;
-        out[i * 4 + 3] = ctx->state[i] & 0xff;
-    }
+    sha256_store_state(ctx->state, out);
 }
 
 void sha256(const uint8_t* data, size_t len, uint8_t out[32]) {
@@ -116,3 +319,47 @@ void sha256(const uint8_t* data, size_t len, uint8_t out[32]) {
     sha256_update(&ctx, data, len);
     sha256_final(&ctx, out);
 }
+
+// ----midstate----
+void sha256_midstate(const uint8_t block[64], uint32_t state[8]) {
+    memcpy(state, IV, sizeof(IV));
+    sha256_transform_impl(state, block, 1);
+}
+
+void sha256_compress(uint32_t state[8], const uint8_t block[64]) {
+    sha256_transform_impl(state, block, 1);
+}
+
+// ----32 字节输入：一次压缩----
+void sha256_32(const uint8_t in[32], uint8_t out[32]) {
+    uint32_t state[8];
+    uint8_t block[64];
+
+    memcpy(block, in, 32);
+    memcpy(block + 32, PAD_32, 32);
+    memcpy(state, IV, sizeof(IV));
+    sha256_transform_impl(state, block, 1);
+    sha256_store_state(state, out);
+}
+
+void sha256d_32(const uint8_t in[32], uint8_t out[32]) {
+    uint8_t tmp[32];
+    sha256_32(in, tmp);
+    sha256_32(tmp, out);
+}
+
+// ----64 字节输入（merkle 父节点）：共三次压缩----
+void sha256d_64(const uint8_t in[64], uint8_t out[32]) {
+    uint32_t state[8];
+    uint8_t block[64];
+
+    memcpy(state, IV, sizeof(IV));
+    sha256_transform_impl(state, in, 1);
+    sha256_transform_impl(state, PAD_64, 1);
+
+    sha256_store_state(state, block);
+    memcpy(block + 32, PAD_32, 32);
+    memcpy(state, IV, sizeof(IV));
+    sha256_transform_impl(state, block, 1);
+    sha256_store_state(state, out);
+}
@@ -7,12 +7,57 @@ typedef struct {
     uint64_t bitlen;
     uint8_t buffer[64];
     size_t buffer_len;
+    void (*transform)(uint32_t state[8], const uint8_t* data, size_t blocks);  // ѹ init ѡ
 } SHA256_CTX;
 
 void sha256_init(SHA256_CTX* ctx);
+void sha256_init_ref(SHA256_CTX* ctx);      // ǿʹòοʵ֣ SIMD/SHA-NI
 void sha256_update(SHA256_CTX* ctx, const uint8_t* data, size_t len);
 void sha256_final(SHA256_CTX* ctx, uint8_t out[32]);
 
+//  cpuid ѡѹʵ֣SHA-NI / AVX2 / SSSE3 / οʵ֣ʱһμ
+// δʱڵһιϣʱԶ
+void sha256_autodetect(void);
+
+// ǰʹõʵƣ־
+const char* sha256_impl_name(void);
+
 // رҳõһԽӿڣȼ sha256(data)
 void sha256(const uint8_t* data, size_t len, uint8_t out[32]);
 
+// ----м״̬midstateǰ 64 ֽڹ̶ʱֻѹһΣ֮ÿֻ仯Ŀ----
+// sha256_midstate: state = ѹ(IV, block)
+// sha256_compress:  state ѹһ 64 ֽڿ飨÷и䣩
+void sha256_midstate(const uint8_t block[64], uint32_t state[8]);
+void sha256_compress(uint32_t state[8], const uint8_t block[64]);
+
+// ----̶ȵרںˣڱԤã----
+// sha256_32 = SHA256(32 ֽ)sha256d_32/sha256d_64 = SHA256(SHA256(x))
+void sha256_32(const uint8_t in[32], uint8_t out[32]);
+void sha256d_32(const uint8_t in[32], uint8_t out[32]);
+void sha256d_64(const uint8_t in[64], uint8_t out[32]);
+
+// ϣ count ȳĶϢ i Ϊ data + i*lenժҪд out + 32*i
+//  CPU ʹ 16 (AVX-512) / 8 (AVX2) / 4 (SSE2) ͨУ sha256() λһ
+// len >= 32 ʱ out  data صԭؼ㣬merkle ϲʹã
+void sha256_batch(const uint8_t* data, size_t len, size_t count, uint8_t* out);
+
+//  count  64 ֽ sha256d_64merkle ͬһиڵ㣩
+//  i Ϊ in + 64*iд out + 32*iout  in ص
+void sha256d_64_batch(const uint8_t* in, size_t count, uint8_t* out);
+
+// ----ڿ nonce ɨ----
+// tail Ϊͷĵڶ 64 ֽڿ飨䣩ֽ 4..7 Ϊ nonce
+// ΰ nonce, nonce+1, ...  count ֵд tail midstate ѹһΣ
+// ǰ zero_bytes ֽΪ 0 ʱѸ nonceСģд *found  1򷵻 0
+typedef int (*sha256_scan_fn)(const uint32_t midstate[8], const uint8_t tail[64],
+    uint32_t nonce, uint32_t count, uint32_t zero_bytes, uint32_t* found);
+
+typedef struct {
+    const char* name;
+    int lanes;              // ÿѹԵ nonce 
+    sha256_scan_fn scan;
+} Sha256ScanKernel;
+
+// ǰ CPU õɨںˣ / AVX2 8 ͨ / AVX-512 16 ͨһǱ
+const Sha256ScanKernel* sha256_scan_kernels(int* count);
@@ -0,0 +1,340 @@
+#include "sha256.h"
+#include "utils/cpu.h"
+#include <string.h>
+#include <pthread.h>
+
+// ----໺ SHA-256N Ϣռһ SIMD ͨͬʱѹ----
+// ״̬Ϣ־ [][ͨ] Уͨ 4 (SSE2) / 8 (AVX2) / 16 (AVX-512)
+
+#define ROTR(x,n)  (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x,y,z)  (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x,y,z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define EP0(x)     (ROTR(x,2)  ^ ROTR(x,13) ^ ROTR(x,22))
+#define EP1(x)     (ROTR(x,6)  ^ ROTR(x,11) ^ ROTR(x,25))
+#define SIG0(x)    (ROTR(x,7)  ^ ROTR(x,18) ^ ((x) >> 3))
+#define SIG1(x)    (ROTR(x,17) ^ ROTR(x,19) ^ ((x) >> 10))
+
+#define MAX_LANES 16
+
+static const uint32_t K[64] = {
+    0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+    0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+    0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+    0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+    0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+    0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+    0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+    0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+};
+
+static const uint32_t IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// 64 ֽϢ顢32 ֽϢĺ 8 ֣ڳתã
+static const uint32_t PAD_64_WORDS[16] = { 0x80000000, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 512 };
+static const uint32_t PAD_32_WORDS[8] = { 0x80000000, 0, 0, 0, 0, 0, 0, 256 };
+
+// state[8*N]w[16*N]һѹ N ͨһ 64 ֽڿ
+typedef void (*sha256_lanes_fn)(uint32_t* state, const uint32_t* w);
+
+//  GCC չдһֺͬȺ target ʵһ
+#define SHA256_DEFINE_LANES(name, vec, lanes, tgt)                              \
+typedef uint32_t vec __attribute__((vector_size(4 * (lanes))));                 \
+__attribute__((target(tgt)))                                                    \
+static void name(uint32_t* state, const uint32_t* w) {                          \
+    vec s[8], m[16], a, b, c, d, e, f, g, h, t1, t2;                            \
+    int i;                                                                      \
+    memcpy(s, state, sizeof(s));                                                \
+    memcpy(m, w, sizeof(m));                                                    \
+    a = s[0]; b = s[1]; c = s[2]; d = s[3];                                     \
+    e = s[4]; f = s[5]; g = s[6]; h = s[7];                                     \
+    _Pragma("GCC unroll 64")                                                    \
+    for (i = 0; i < 64; i++) {                                                  \
+        if (i >= 16)                                                            \
+            m[i & 15] += SIG1(m[(i - 2) & 15]) + m[(i - 7) & 15] + SIG0(m[(i - 15) & 15]); \
+        t1 = h + EP1(e) + CH(e, f, g) + K[i] + m[i & 15];                       \
+        t2 = EP0(a) + MAJ(a, b, c);                                             \
+        h = g; g = f; f = e; e = d + t1;                                        \
+        d = c; c = b; b = a; a = t1 + t2;                                       \
+    }                                                                           \
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;                                 \
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;                                 \
+    memcpy(state, s, sizeof(s));                                                \
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+SHA256_DEFINE_LANES(sha256_lanes_x4, v4u32, 4, "sse2")
+SHA256_DEFINE_LANES(sha256_lanes_x8, v8u32, 8, "avx2")
+SHA256_DEFINE_LANES(sha256_lanes_x16, v16u32, 16, "avx512f")
+#endif
+
+static uint32_t load_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+//  N ͨԵ 64 ֽڿתΪ [][ͨ]
+static void load_block_words(uint32_t* w, const uint8_t* const* blocks, int lanes) {
+    for (int j = 0; j < 16; j++)
+        for (int l = 0; l < lanes; l++)
+            w[j * lanes + l] = load_be32(blocks[l] + 4 * j);
+}
+
+// ͬһ鳣ֹ㲥ͨ
+static void broadcast_words(uint32_t* w, const uint32_t* words, int count, int lanes) {
+    for (int j = 0; j < count; j++)
+        for (int l = 0; l < lanes; l++)
+            w[j * lanes + l] = words[j];
+}
+
+static void init_lane_state(uint32_t* state, int lanes) {
+    broadcast_words(state, IV, 8, lanes);
+}
+
+static void store_lane_digests(const uint32_t* state, int lanes, uint8_t* out) {
+    for (int l = 0; l < lanes; l++) {
+        uint8_t* o = out + 32 * (size_t)l;
+        for (int j = 0; j < 8; j++) {
+            uint32_t v = state[j * lanes + l];
+            o[4 * j] = (uint8_t)(v >> 24);
+            o[4 * j + 1] = (uint8_t)(v >> 16);
+            o[4 * j + 2] = (uint8_t)(v >> 8);
+            o[4 * j + 3] = (uint8_t)v;
+        }
+    }
+}
+
+// ----һ lanes ȳϢ SHA-256䣩----
+// ȶȫд len >= 32 ʱ out  data ԭص
+static void sha256_lanes_group(sha256_lanes_fn fn, int lanes,
+    const uint8_t* data, size_t len, uint8_t* out)
+{
+    uint32_t state[8 * MAX_LANES];
+    uint32_t w[16 * MAX_LANES];
+    uint8_t tail[MAX_LANES][128];
+    const uint8_t* blocks[MAX_LANES];
+
+    init_lane_state(state, lanes);
+
+    size_t full = len / 64;
+    for (size_t b = 0; b < full; b++) {
+        for (int l = 0; l < lanes; l++)
+            blocks[l] = data + (size_t)l * len + b * 64;
+        load_block_words(w, blocks, lanes);
+        fn(state, w);
+    }
+
+    // β + 0x80 +  + 64 λȣ 1  2 
+    size_t rem = len - full * 64;
+    size_t tail_len = rem < 56 ? 64 : 128;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int l = 0; l < lanes; l++) {
+        memset(tail[l], 0, tail_len);
+        memcpy(tail[l], data + (size_t)l * len + full * 64, rem);
+        tail[l][rem] = 0x80;
+        for (int k = 0; k < 8; k++)
+            tail[l][tail_len - 1 - k] = (uint8_t)(bits >> (8 * k));
+    }
+    for (size_t off = 0; off < tail_len; off += 64) {
+        for (int l = 0; l < lanes; l++)
+            blocks[l] = tail[l] + off;
+        load_block_words(w, blocks, lanes);
+        fn(state, w);
+    }
+
+    store_lane_digests(state, lanes, out);
+}
+
+// ----һ lanes  64 ֽ SHA256D----
+// ֮״ֱ̬ΪһֵϢֽ֣л
+static void sha256d_64_lanes_group(sha256_lanes_fn fn, int lanes, const uint8_t* in, uint8_t* out) {
+    uint32_t state[8 * MAX_LANES];
+    uint32_t w[16 * MAX_LANES];
+    const uint8_t* blocks[MAX_LANES];
+
+    init_lane_state(state, lanes);
+    for (int l = 0; l < lanes; l++)
+        blocks[l] = in + 64 * (size_t)l;
+    load_block_words(w, blocks, lanes);
+    fn(state, w);
+
+    broadcast_words(w, PAD_64_WORDS, 16, lanes);
+    fn(state, w);
+
+    memcpy(w, state, sizeof(uint32_t) * 8 * lanes);
+    broadcast_words(w + 8 * lanes, PAD_32_WORDS, 8, lanes);
+    init_lane_state(state, lanes);
+    fn(state, w);
+
+    store_lane_digests(state, lanes, out);
+}
+
+// ---- CPU ѡõͨȣӿխ----
+typedef struct {
+    sha256_lanes_fn fn;
+    int lanes;
+} LaneKernel;
+
+static LaneKernel g_kernels[3];
+static int g_kernel_count = 0;
+static pthread_once_t g_kernels_once = PTHREAD_ONCE_INIT;
+
+static void select_kernels(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    const CpuFeatures* cpu = cpu_features();
+    if (cpu->avx512f)
+        g_kernels[g_kernel_count++] = (LaneKernel){ sha256_lanes_x16, 16 };
+    //  SHA-NI ʱϢѱ 8 ͨ AVX2 / 4 ͨ SSE2 죬ʣಿ
+    if (!cpu->sha) {
+        if (cpu->avx2)
+            g_kernels[g_kernel_count++] = (LaneKernel){ sha256_lanes_x8, 8 };
+        g_kernels[g_kernel_count++] = (LaneKernel){ sha256_lanes_x4, 4 };
+    }
+#endif
+}
+
+// ----ϣ----
+void sha256_batch(const uint8_t* data, size_t len, size_t count, uint8_t* out) {
+    pthread_once(&g_kernels_once, select_kernels);
+
+    size_t i = 0;
+    for (int k = 0; k < g_kernel_count; k++) {
+        size_t lanes = (size_t)g_kernels[k].lanes;
+        for (; count - i >= lanes; i += lanes)
+            sha256_lanes_group(g_kernels[k].fn, (int)lanes, data + i * len, len, out + 32 * i);
+    }
+
+    // ˣͨλһ
+    for (; i < count; i++)
+        sha256(data + i * len, len, out + 32 * i);
+}
+
+// ---- merkle ڵ----
+void sha256d_64_batch(const uint8_t* in, size_t count, uint8_t* out) {
+    pthread_once(&g_kernels_once, select_kernels);
+
+    size_t i = 0;
+    for (int k = 0; k < g_kernel_count; k++) {
+        size_t lanes = (size_t)g_kernels[k].lanes;
+        for (; count - i >= lanes; i += lanes)
+            sha256d_64_lanes_group(g_kernels[k].fn, (int)lanes, in + 64 * i, out + 32 * i);
+    }
+
+    for (; i < count; i++)
+        sha256d_64(in + 64 * i, out + 32 * i);
+}
+
+// =====================================================
+// ڿ nonce ɨ裺midstate ̶βֻ nonce һڱ
+// =====================================================
+
+// ѹǰ zero_bytes ֽڣˣǷΪ 0state  j λ state[j * stride]
+static int state_has_zero_prefix(const uint32_t* state, size_t stride, uint32_t zero_bytes) {
+    uint32_t words = zero_bytes / 4;
+    for (uint32_t j = 0; j < words; j++)
+        if (state[j * stride] != 0) return 0;
+
+    uint32_t rem = zero_bytes % 4;
+    if (rem && (state[words * stride] >> (32 - 8 * rem)) != 0) return 0;
+    return 1;
+}
+
+static uint32_t clamp_zero_bytes(uint32_t zero_bytes) {
+    return zero_bytes > 32 ? 32 : zero_bytes;
+}
+
+// ----ÿ nonce ѹһΣsha256_compress  CPU ɣ SHA-NI----
+static int sha256_scan_scalar(const uint32_t midstate[8], const uint8_t tail[64],
+    uint32_t nonce, uint32_t count, uint32_t zero_bytes, uint32_t* found)
+{
+    uint8_t block[64];
+    memcpy(block, tail, sizeof(block));
+    zero_bytes = clamp_zero_bytes(zero_bytes);
+
+    for (uint32_t i = 0; i < count; i++, nonce++) {
+        uint32_t state[8];
+        memcpy(state, midstate, sizeof(state));
+        block[4] = (uint8_t)(nonce >> 24);
+        block[5] = (uint8_t)(nonce >> 16);
+        block[6] = (uint8_t)(nonce >> 8);
+        block[7] = (uint8_t)nonce;
+        sha256_compress(state, block);
+
+        if (state_has_zero_prefix(state, 1, zero_bytes)) {
+            *found = nonce;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ----ͨÿͨһ nonceһѹ lanes  nonce----
+// ֻϢ w[1] ֺͨͬͳʼ״̬ǹ㲥ֵ
+static int sha256_scan_lanes(sha256_lanes_fn fn, int lanes, const uint32_t midstate[8],
+    const uint8_t tail[64], uint32_t nonce, uint32_t count, uint32_t zero_bytes, uint32_t* found)
+{
+    uint32_t mid[8 * MAX_LANES];
+    uint32_t state[8 * MAX_LANES];
+    uint32_t w[16 * MAX_LANES];
+    uint32_t words[16];
+
+    for (int j = 0; j < 16; j++)
+        words[j] = load_be32(tail + 4 * j);
+    broadcast_words(w, words, 16, lanes);
+    broadcast_words(mid, midstate, 8, lanes);
+    zero_bytes = clamp_zero_bytes(zero_bytes);
+
+    uint32_t i = 0;
+    for (; count - i >= (uint32_t)lanes; i += lanes) {
+        for (int l = 0; l < lanes; l++)
+            w[lanes + l] = nonce + i + l;
+        memcpy(state, mid, sizeof(uint32_t) * 8 * lanes);
+        fn(state, w);
+
+        // ͨ˳飬֤СЧ nonce
+        for (int l = 0; l < lanes; l++) {
+            if (state_has_zero_prefix(state + l, lanes, zero_bytes)) {
+                *found = nonce + i + l;
+                return 1;
+            }
+        }
+    }
+
+    // һβ
+    return sha256_scan_scalar(midstate, tail, nonce + i, count - i, zero_bytes, found);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+static int sha256_scan_x8(const uint32_t midstate[8], const uint8_t tail[64],
+    uint32_t nonce, uint32_t count, uint32_t zero_bytes, uint32_t* found)
+{
+    return sha256_scan_lanes(sha256_lanes_x8, 8, midstate, tail, nonce, count, zero_bytes, found);
+}
+
+static int sha256_scan_x16(const uint32_t midstate[8], const uint8_t tail[64],
+    uint32_t nonce, uint32_t count, uint32_t zero_bytes, uint32_t* found)
+{
+    return sha256_scan_lanes(sha256_lanes_x16, 16, midstate, tail, nonce, count, zero_bytes, found);
+}
+#endif
+
+static Sha256ScanKernel g_scan_kernels[3];
+static int g_scan_kernel_count = 0;
+static pthread_once_t g_scan_once = PTHREAD_ONCE_INIT;
+
+static void select_scan_kernels(void) {
+    g_scan_kernels[g_scan_kernel_count++] = (Sha256ScanKernel){ "scalar", 1, sha256_scan_scalar };
+#if defined(__x86_64__) || defined(__i386__)
+    const CpuFeatures* cpu = cpu_features();
+    if (cpu->avx2)
+        g_scan_kernels[g_scan_kernel_count++] = (Sha256ScanKernel){ "avx2-x8", 8, sha256_scan_x8 };
+    if (cpu->avx512f)
+        g_scan_kernels[g_scan_kernel_count++] = (Sha256ScanKernel){ "avx512-x16", 16, sha256_scan_x16 };
+#endif
+}
+
+const Sha256ScanKernel* sha256_scan_kernels(int* count) {
+    pthread_once(&g_scan_once, select_scan_kernels);
+    *count = g_scan_kernel_count;
+    return g_scan_kernels;
+}
@@ -26,7 +26,7 @@ size_t node_pubkey_len = 0;
 Blockchain* blockchain = NULL;
 
 // ȫ UTXO 
-UTXO* utxo_set = NULL;
+UTXOSet* utxo_set = NULL;
 
 // ȫڴ
 Mempool mempool;
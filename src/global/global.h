@@ -32,7 +32,7 @@ extern size_t node_pubkey_len;
 extern Blockchain* blockchain;
 
 // UTXO 
-extern UTXO* utxo_set;
+extern UTXOSet* utxo_set;
 
 // ȫڴ
 extern Mempool mempool;
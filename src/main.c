@@ -9,11 +9,19 @@
 #include <global/global.h>
 #include <core/block/block.h>
 #include <core/block/blockchain.h>
+#include <core/block/miner.h>
 #include <wallet/wallet.h>
 #include <core/utxo_set.h>
 #include <core/tx_pool.h>
+#include <core/sig_cache.h>
 #include <p2p/p2p.h>
 #include <core/transaction.h>
+#include <crypto/sha256.h>
+#include <crypto/hash.h>
+#include <crypto/base58.h>
+#include <crypto/ripemd160.h>
+#include <crypto/crypto_tools.h>
+#include <crypto/pubkey_cache.h>
 
 #define MINING_REWARD 100
 
@@ -45,7 +53,7 @@ extern size_t node_pubkey_len;
 extern Blockchain* blockchain;
 
 // UTXO 集
-extern UTXO* utxo_set;
+extern UTXOSet* utxo_set;
 
 // 全局内存池
 extern Mempool mempool;
@@ -57,8 +65,9 @@ char wif[128];
 
 //------------------------------------------------------
 //     创建 coinbase（挖矿奖励） 交易
+//     height 为新区块的高度，用作 extranonce 初值，让每个区块的 coinbase txid 都不同
 //------------------------------------------------------
-Tx* build_coinbase_tx(UTXO** utxo_set_ptr, Mempool* pool_ptr, const char* miner_addr)
+Tx* build_coinbase_tx(UTXOSet** utxo_set_ptr, Mempool* pool_ptr, const char* miner_addr, uint32_t height)
 {
     if (!miner_addr) 
     {
@@ -76,12 +85,20 @@ Tx* build_coinbase_tx(UTXO** utxo_set_ptr, Mempool* pool_ptr, const char* miner_
     // Coinbase 输入为空，只有奖励输出
     add_txout(tx, miner_addr, MINING_REWARD);
 
+    // 同一地址、同一金额的 coinbase 只靠 extranonce 区分；txid 相同会在 UTXO 集里顶掉之前的奖励
+    // 从高度起步，万一撞上还没花掉的奖励（例如上一块挖矿时 extranonce 递增过）就继续往后换
+    tx->extranonce = height;
+    while (*utxo_set_ptr && find_utxo(*utxo_set_ptr, tx_txid(tx), 0)) {
+        tx->extranonce++;
+        tx->txid_valid = 0;
+    }
+
     // coinbase 正常情况下不需要签名，使用 dummy 私钥保持统一处理
     unsigned char dummy_priv[32] = { 0 };
     sign_tx(tx, dummy_priv);
 
     // 计算 coinbase txid
-    tx_hash(tx, tx->txid);
+    tx_txid(tx);
 
     // 将 coinbase 加入 tx_pool
     if (pool_ptr) {
@@ -95,6 +112,125 @@ Tx* build_coinbase_tx(UTXO** utxo_set_ptr, Mempool* pool_ptr, const char* miner_
     return tx;
 }
 
+// 区块没有挖出来时撤销 coinbase：奖励 UTXO、交易池里的 coinbase 和交易本身一起释放
+static void discard_coinbase_tx(Tx* reward)
+{
+    remove_utxo(&utxo_set, reward->txid, 0);
+    tx_pool_remove_tx(&mempool, reward->txid);
+    free_tx(reward);
+    free(reward);
+}
+
+
+//------------------------------------------------------
+// 区块模板：coinbase + 交易池中的交易（按进入交易池的先后顺序）
+//------------------------------------------------------
+static BlockTemplate block_template;
+static int block_template_ready = 0;
+
+static void reset_block_template(void)
+{
+    if (block_template_ready) {
+        block_template_free(&block_template);
+        block_template_ready = 0;
+    }
+}
+
+static int cmp_mempool_txid(const void* a, const void* b)
+{
+    return memcmp((*(MempoolTx* const*)a)->txid, (*(MempoolTx* const*)b)->txid, 32);
+}
+
+static int cmp_txid(const void* a, const void* b)
+{
+    return memcmp(a, b, 32);
+}
+
+// 按 txid 把模板和交易池对齐，成员只认 txid，不看交易池的数量
+// 链尾变了或模板里有交易已离开交易池时整个模板重建；交易池里的新交易按进入的先后追加
+// 返回与模板 txids 一一对应的交易指针数组（[0] 为 coinbase，调用方 free），失败返回 NULL
+static Tx** sync_block_template(const unsigned char prev_hash[32], Tx* coinbase)
+{
+    uint32_t pool_count = 0;
+    for (MempoolTx* p = mempool.head; p; p = p->next) pool_count++;
+
+    // list 按链表顺序（新的在前），sorted 按 txid 排序用于查找
+    MempoolTx** list = malloc(sizeof(MempoolTx*) * (pool_count + 1));
+    MempoolTx** sorted = malloc(sizeof(MempoolTx*) * (pool_count + 1));
+    unsigned char (*members)[32] = NULL;
+    Tx** txs = NULL;
+    if (!list || !sorted) goto fail;
+
+    uint32_t n = 0;
+    for (MempoolTx* p = mempool.head; p; p = p->next) list[n++] = p;
+    memcpy(sorted, list, sizeof(MempoolTx*) * pool_count);
+    qsort(sorted, pool_count, sizeof(MempoolTx*), cmp_mempool_txid);
+
+    if (block_template_ready && memcmp(block_template.prev_hash, prev_hash, 32) != 0)
+        reset_block_template();
+
+    for (;;) {
+        if (!block_template_ready) {
+            if (!block_template_init(&block_template, prev_hash)) goto fail;
+            block_template_ready = 1;
+        }
+
+        txs = malloc(sizeof(Tx*) * (block_template.tx_count + pool_count));
+        if (!txs) goto fail;
+        txs[0] = coinbase;
+
+        // 已在模板里的交易从交易池取当前内容；有一笔找不到就重建
+        MempoolTx key;
+        MempoolTx* keyp = &key;
+        uint32_t i = 1;
+        for (; i < block_template.tx_count; i++) {
+            memcpy(key.txid, block_template.txids[i], 32);
+            MempoolTx** hit = bsearch(&keyp, sorted, pool_count, sizeof(MempoolTx*), cmp_mempool_txid);
+            if (!hit) break;
+            txs[i] = (*hit)->tx;
+        }
+        if (i == block_template.tx_count) break;
+
+        free(txs);
+        txs = NULL;
+        reset_block_template();
+    }
+
+    // 模板现有成员排序后查找，交易池里不在其中的就是新交易
+    uint32_t member_count = block_template.tx_count - 1;
+    members = malloc(32 * (size_t)(member_count + 1));
+    if (!members) goto fail;
+    memcpy(members, block_template.txids + 1, 32 * (size_t)member_count);
+    qsort(members, member_count, 32, cmp_txid);
+
+    // 先进入交易池的先放；本次的 coinbase 也在交易池里，它只占 [0]
+    const unsigned char* coinbase_txid = tx_txid(coinbase);
+    for (uint32_t i = pool_count; i-- > 0; ) {
+        MempoolTx* p = list[i];
+        if (memcmp(p->txid, coinbase_txid, 32) == 0) continue;
+        if (bsearch(p->txid, members, member_count, 32, cmp_txid)) continue;
+
+        if (!block_template_add_tx(&block_template, p->txid)) goto fail;
+        txs[block_template.tx_count - 1] = p->tx;
+    }
+
+    if (!block_template_set_coinbase(&block_template, coinbase_txid)) goto fail;
+
+    free(members);
+    free(sorted);
+    free(list);
+    return txs;
+
+fail:
+    // 模板可能只更新了一半，下次整个重建
+    reset_block_template();
+    free(txs);
+    free(members);
+    free(sorted);
+    free(list);
+    return NULL;
+}
+
 
 //------------------------------------------------------
 // 构造 + 挖掘区块（矿工）
@@ -107,59 +243,71 @@ Block* build_and_mine_block()
     }
     printf("[Mining] Constructing block...\n");
 
-    // 获取链尾
+    // 先记下取消代数再读链尾：读完之后到达的对端区块一定能取消本次挖矿
+    unsigned int cancel_gen = miner_generation();
+
+    // 获取链尾和新区块的高度
     Blockchain* tail = blockchain;
-    while (tail->next) tail = tail->next;
+    uint32_t height = 1;
+    while (tail->next) { tail = tail->next; height++; }
     Block* prev = tail->block;
 
     // 生成交易奖励
-    Tx* reward = build_coinbase_tx(&utxo_set, &mempool, addr);
+    Tx* reward = build_coinbase_tx(&utxo_set, &mempool, addr, height);
     if (!reward) {
         printf("[Mining] coinbase build failed.\n");
         return NULL;
     }
 
-    // 获取 txpool 中t交易的数量
-    int tx_count = 1;
-    MempoolTx* p = mempool.head;
-    while (p) { tx_count++; p = p->next; }
-
-    // 为 block 构造 tx 数组（在栈上分配合理范围内的数组）
-    Tx* txlist = malloc(sizeof(Tx) * tx_count);
-    if (!txlist) {
-        free(reward);
+    // 把交易池里的新交易补进模板，再换上本次的 coinbase，都只更新 merkle 路径
+    Tx** txs = sync_block_template(prev->header.block_hash, reward);
+    if (!txs) {
+        printf("[Mining] block template update failed.\n");
+        discard_coinbase_tx(reward);
         return NULL;
     }
-    txlist[0] = *reward;
-    int i = 1;
-
-    p = mempool.head;
-
-    while (p) {
-        txlist[i++] = *(p->tx); 
-        p = p->next;
-    }
+    int tx_count = (int)block_template.tx_count;
 
     // 创建block
-    Block* block = create_block(prev->header.block_hash, txlist, (uint32_t)tx_count);
+    Block* block = block_template_to_block(&block_template, txs);
+    free(txs);
     if (!block) 
     {
-        free(txlist);//释放
+        discard_coinbase_tx(reward);
         return NULL;
     }
     //开始挖矿
     printf("[Mining] Start mining block...\n");
-    mine_block(block, 2);
+    if (!mine_block(block, 2, cancel_gen)) {
+        printf("[Mining] Mining cancelled, block discarded.\n");
+        // 区块里的交易与交易池共用输入/输出，只释放区块自己的数组和 merkle 缓存
+        block_merkle_cache_clear(block);
+        free(block->txs);
+        free(block);
+        discard_coinbase_tx(reward);
+        return NULL;
+    }
 
-    // 加入本地链
+    // 挖矿中 extranonce 变过时 coinbase txid 也变了，本地奖励 UTXO 随之更新
+    if (memcmp(block->txs[0].txid, reward->txid, 32) != 0) {
+        remove_utxo(&utxo_set, reward->txid, 0);
+        update_utxo_set(&utxo_set, &block->txs[0], block->txs[0].txid);
+    }
+
+    // 加入本地链；链尾已换成这个区块，模板作废
     blockchain = blockchain_add(blockchain, block);
+    reset_block_template();
+
+    // 已上链的交易移出交易池，否则下一个区块会再打包一次（coinbase 按入池时的 txid 删除）
+    tx_pool_remove_tx(&mempool, reward->txid);
+    for (uint32_t i = 1; i < block->tx_count; i++)
+        tx_pool_remove_tx(&mempool, tx_txid(&block->txs[i]));
 
     //广播给peers
     broadcast_block(block);
 
     printf("[Mining] Block mined, %d transactions included.\n", tx_count);
 
-    free(txlist);
     return block;
 }
 
@@ -197,6 +345,7 @@ void handle_user_transaction()
     printf("[TX] Added transaction to tx_pool.\n");
 
     // 自动挖一个只包含此交易的区块
+    unsigned int cancel_gen = miner_generation();
     Blockchain* tail = blockchain;
     while (tail->next) tail = tail->next;
 
@@ -204,9 +353,21 @@ void handle_user_transaction()
     Tx txlist[1];
     txlist[0] = *tx;
     Block* b = create_block(prev->header.block_hash, txlist, 1);
+    if (!b) {
+        printf("[Mining] block build failed.\n");
+        return;
+    }
     printf("[Mining] Mining block for new TX...\n");
-    mine_block(b, 2);
+    if (!mine_block(b, 2, cancel_gen)) {
+        printf("[Mining] Mining cancelled, block discarded.\n");
+        // 交易仍留在交易池里等下一个区块，这里只释放区块本身
+        block_merkle_cache_clear(b);
+        free(b->txs);
+        free(b);
+        return;
+    }
     blockchain = blockchain_add(blockchain, b);
+    tx_pool_remove_tx(&mempool, tx_txid(tx));
     broadcast_block(b);
 
     printf("[Block] New block mined .\n");
@@ -224,11 +385,11 @@ void start_as_server()
 
     // 创建并挖掘创世区块
     Block* genesis = create_genesis_block(addr);
-    mine_block(genesis, 1);
+    mine_block(genesis, 1, miner_generation());
     blockchain = blockchain_add(NULL, genesis);
 
     unsigned char genesis_txid[32];
-    tx_hash(&genesis->txs[0], genesis_txid);
+    memcpy(genesis_txid, tx_txid(&genesis->txs[0]), 32);
 
     // 给矿工生成初始UTXO
     add_utxo(&utxo_set, genesis_txid, 0, addr, 0);
@@ -328,9 +489,15 @@ void bitcoin_menu()
             print_utxo_set(utxo_set);
             break;
 
-        case 7:
+        case 7: {
             tx_pool_print(&mempool);
+
+            uint64_t hits, misses;
+            pubkey_cache_stats(&hits, &misses);
+            printf("[Verify] pubkey cache: %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate)\n",
+                hits, misses, hits + misses ? 100.0 * hits / (hits + misses) : 0.0);
             break;
+        }
 
         case 8: {
             uint64_t bal = get_balance(utxo_set, addr);
@@ -357,6 +524,40 @@ int main()
     global_init();
     tx_pool_init(&mempool);
 
+    // 按 CPU 特性选择 SHA-256 实现，再测速选出哈希后端（可用环境变量 BITCOIN_HASH_BACKEND 指定）
+    sha256_autodetect();
+    const char* backend = getenv("BITCOIN_HASH_BACKEND");
+    if (!backend || !hash_backend_select(backend))
+        backend = hash_backend_autoselect();
+    printf("[Crypto] SHA-256 implementation: %s, hash backend: %s\n", sha256_impl_name(), backend);
+
+    // 地址用到的 RIPEMD-160 和 Base58：已知向量 + 批量与逐条比对，出错就不能继续
+    if (!ripemd160_selftest()) {
+        printf("[Crypto] RIPEMD-160 self-test failed.\n");
+        return 1;
+    }
+    if (!base58_selftest()) {
+        printf("[Crypto] Base58 self-test failed.\n");
+        return 1;
+    }
+
+    // secp256k1 上下文创建并随机化一次，签名/验签全程共享
+    crypto_secp_init();
+
+    // 签名缓存容量（条目数），BITCOIN_SIGCACHE_ENTRIES 可调整，默认 65536
+    const char* sigcache = getenv("BITCOIN_SIGCACHE_ENTRIES");
+    sig_cache_init(sigcache ? (size_t)strtoull(sigcache, NULL, 10) : 0);
+
+    // 挖矿线程数与 CPU 绑定（BITCOIN_MINER_THREADS 默认为 CPU 核数，设置 BITCOIN_MINER_PIN 则绑核）
+    const char* threads = getenv("BITCOIN_MINER_THREADS");
+    miner_configure(threads ? atoi(threads) : 0, getenv("BITCOIN_MINER_PIN") != NULL);
+
+    // nonce 扫描内核：BITCOIN_MINER_KERNEL 指定，否则自测测速后选择
+    const char* kernel = getenv("BITCOIN_MINER_KERNEL");
+    if (!kernel || !miner_select_kernel(kernel))
+        kernel = miner_autoselect_kernel();
+    printf("[Miner] nonce scan kernel: %s\n", kernel);
+
     // 生成私钥、公钥、地址
     generate_privkey(priv);
     privkey_to_pubkey_and_addr(priv, pub, &publen, addr, sizeof(addr), 1);
@@ -468,11 +669,11 @@ int main()
 
         // 创建并挖掘创世区块
         Block* genesis = create_genesis_block(addr);
-        mine_block(genesis, 1);
+        mine_block(genesis, 1, miner_generation());
         blockchain = blockchain_add(NULL, genesis);
 
         unsigned char genesis_txid[32];
-        tx_hash(&genesis->txs[0], genesis_txid);
+        memcpy(genesis_txid, tx_txid(&genesis->txs[0]), 32);
 
         // 创世区块给 addr 一个 UTXO，并给50作为初始
         add_utxo(&utxo_set, genesis_txid, 0, addr, 50);
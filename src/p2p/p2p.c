@@ -10,6 +10,8 @@
 
 #include "wallet/wallet.h"
 #include "core/utxo_set.h"
+#include "crypto/pubkey_cache.h"
+#include "core/block/miner.h"
 #include "global/global.h"
 
 
@@ -70,14 +72,26 @@ static int find_peer(int sock) {
     return idx;
 }
 
+// 编码长度不超过缓冲区
+static size_t txin_sig_len(const TxIn* in) {
+    return in->sig_len <= sizeof(in->signature) ? in->sig_len : sizeof(in->signature);
+}
+
+static size_t txin_pubkey_len(const TxIn* in) {
+    return in->pubkey_len <= sizeof(in->pubkey) ? in->pubkey_len : sizeof(in->pubkey);
+}
+
 // ---- Tx 序列化 ----
 unsigned char* serialize_tx(Tx* tx, size_t* out_len) {
-    // 预估序列化后的长度
-    size_t len = 
+    // 输入按实际长度编码：txid | index | 签名长度(1) | 签名 | 公钥长度(1) | 公钥
+    // 可恢复签名的输入没有公钥，共 32 + 4 + 1 + 65 + 1 = 103 字节
+    size_t len = sizeof(uint32_t);
+    for (uint32_t i = 0; i < tx->input_count; i++)
+        len += 32 + sizeof(uint32_t) + 1 + txin_sig_len(&tx->inputs[i]) + 1 + txin_pubkey_len(&tx->inputs[i]);
+    len +=
         sizeof(uint32_t) 
-        + tx->input_count * (32 + sizeof(uint32_t) + 64 + sizeof(size_t) + 65 + sizeof(size_t))
-        + sizeof(uint32_t) 
         + tx->output_count * (35 + sizeof(uint32_t)) 
+        + sizeof(uint32_t)
         + 32;
 
     unsigned char* buf = malloc(len);
@@ -96,14 +110,14 @@ unsigned char* serialize_tx(Tx* tx, size_t* out_len) {
         p += 32;
         memcpy(p, &in->output_index, sizeof(uint32_t)); 
         p += sizeof(uint32_t);
-        memcpy(p, in->signature, 64); 
-        p += 64;
-        memcpy(p, &in->sig_len, sizeof(size_t)); 
-        p += sizeof(size_t);
-        memcpy(p, in->pubkey, 65); 
-        p += 65;
-        memcpy(p, &in->pubkey_len, sizeof(size_t)); 
-        p += sizeof(size_t);
+        size_t sig_len = txin_sig_len(in);
+        *p++ = (unsigned char)sig_len;
+        memcpy(p, in->signature, sig_len);
+        p += sig_len;
+        size_t pubkey_len = txin_pubkey_len(in);
+        *p++ = (unsigned char)pubkey_len;
+        memcpy(p, in->pubkey, pubkey_len);
+        p += pubkey_len;
     }
 
     // 写入输出
@@ -118,6 +132,10 @@ unsigned char* serialize_tx(Tx* tx, size_t* out_len) {
         p += sizeof(uint32_t);
     }
 
+    // 写入 coinbase 额外随机数
+    memcpy(p, &tx->extranonce, sizeof(uint32_t));
+    p += sizeof(uint32_t);
+
     // 写入 txid
     memcpy(p, tx->txid, 32); 
     p += 32;
@@ -135,43 +153,80 @@ Tx* deserialize_tx(unsigned char* buf, size_t len) {
     if (!tx) return NULL;
     memset(tx, 0, sizeof(Tx));
 
+    // 每个输入至少 txid + 索引 + 签名长度 + 64 字节签名 + 公钥长度，每个输出固定 35 + 4 字节
+    const long min_input = 32 + (long)sizeof(uint32_t) + 1 + TXIN_SIG_COMPACT + 1;
+    const long output_size = 35 + (long)sizeof(uint32_t);
+
+    const unsigned char* end = buf + len;
     memcpy(&tx->input_count, p, sizeof(uint32_t)); 
     p += sizeof(uint32_t);
 
+    // 数量先和剩余长度比较，避免按对端给的数量申请巨大内存
+    if (tx->input_count > (end - p) / min_input) goto bad;
     if (tx->input_count > 0) {
-        tx->inputs = malloc(sizeof(TxIn) * tx->input_count);
-        memset(tx->inputs, 0, sizeof(TxIn) * tx->input_count);
+        tx->inputs = calloc(tx->input_count, sizeof(TxIn));
+        if (!tx->inputs) goto bad;
     }
     else tx->inputs = NULL;
 
     for (uint32_t i = 0; i < tx->input_count; i++) {
         TxIn* in = &tx->inputs[i];
 
+        if (end - p < 32 + (long)sizeof(uint32_t) + 1) goto bad;
         memcpy(in->txid, p, 32); p += 32;
         memcpy(&in->output_index, p, sizeof(uint32_t)); p += sizeof(uint32_t);
-        memcpy(in->signature, p, 64); p += 64;
-        memcpy(&in->sig_len, p, sizeof(size_t)); p += sizeof(size_t);
-        memcpy(in->pubkey, p, 65); p += 65;
-        memcpy(&in->pubkey_len, p, sizeof(size_t)); p += sizeof(size_t);
+
+        // 签名只能是 64（带公钥）或 65（可恢复）字节
+        in->sig_len = *p++;
+        if ((in->sig_len != TXIN_SIG_COMPACT && in->sig_len != TXIN_SIG_RECOVERABLE) ||
+            end - p < (long)in->sig_len + 1) goto bad;
+        memcpy(in->signature, p, in->sig_len); p += in->sig_len;
+
+        // 公钥：0（可恢复签名）、33（压缩）或 65（非压缩，转成压缩格式保存）
+        size_t pubkey_len = *p++;
+        if (end - p < (long)pubkey_len) goto bad;
+        if (pubkey_len == 65) {
+            if (!pubkey_cache_compress(p, 65, in->pubkey)) goto bad;
+            in->pubkey_len = TXIN_PUBKEY_LEN;
+        }
+        else if (pubkey_len == 0 || pubkey_len == TXIN_PUBKEY_LEN) {
+            memcpy(in->pubkey, p, pubkey_len);
+            in->pubkey_len = pubkey_len;
+        }
+        else goto bad;
+        p += pubkey_len;
     }
 
+    if (end - p < (long)sizeof(uint32_t)) goto bad;
     memcpy(&tx->output_count, p, sizeof(uint32_t));
     p += sizeof(uint32_t);
 
+    if (tx->output_count > (end - p) / output_size) goto bad;
     if (tx->output_count > 0) {
-        tx->outputs = malloc(sizeof(TxOut) * tx->output_count);
-        memset(tx->outputs, 0, sizeof(TxOut) * tx->output_count);
+        tx->outputs = calloc(tx->output_count, sizeof(TxOut));
+        if (!tx->outputs) goto bad;
     }
     else tx->outputs = NULL;
 
     for (uint32_t i = 0; i < tx->output_count; i++) {
         TxOut* out = &tx->outputs[i];
+        if (end - p < output_size) goto bad;
         memcpy(out->addr, p, 35); p += 35;
         memcpy(&out->amount, p, sizeof(uint32_t)); p += sizeof(uint32_t);
     }
 
+    // extranonce + txid
+    if (end - p < (long)sizeof(uint32_t) + 32) goto bad;
+    memcpy(&tx->extranonce, p, sizeof(uint32_t)); p += sizeof(uint32_t);
     memcpy(tx->txid, p, 32); p += 32;
+    tx->txid_valid = 0;     // 对端发来的 txid 不可信，用到时重新计算
     return tx;
+
+bad:
+    printf("[P2P] Malformed transaction, dropped.\n");
+    free_tx(tx);
+    free(tx);
+    return NULL;
 }
 
 // ---- 区块序列化/反序列化 ----
@@ -221,35 +276,43 @@ Block* deserialize_block(unsigned char* buf, size_t len) {
     b->tx_count = 0;
     b->txs = NULL;
 
-    // ---- 计算交易数量 ----
+    // ---- 计算交易数量（每笔的长度都不能超出剩余数据） ----
+    const unsigned char* end = buf + len;
     unsigned char* q = p;
-    while (q < buf + len) {
+    while (q < end) {
         uint32_t tx_size;
+        if (end - q < (long)sizeof(uint32_t)) goto bad;
         memcpy(&tx_size, q, sizeof(uint32_t));
-        q += sizeof(uint32_t) + tx_size;
+        q += sizeof(uint32_t);
+        if ((size_t)(end - q) < tx_size) goto bad;
+        q += tx_size;
         b->tx_count++;
     }
 
     //申请空间
     if (b->tx_count > 0) {
-        b->txs = malloc(sizeof(Tx) * b->tx_count);
-        memset(b->txs, 0, sizeof(Tx) * b->tx_count);
+        b->txs = calloc(b->tx_count, sizeof(Tx));
+        if (!b->txs) goto bad;
     }
     else b->txs = NULL;
 
-    // ---- 解析每笔交易 ----
+    // ---- 解析每笔交易：任何一笔解析失败整个区块丢弃 ----
     for (uint32_t i = 0; i < b->tx_count; i++) {
         uint32_t tx_size;
         memcpy(&tx_size, p, sizeof(uint32_t)); p += sizeof(uint32_t);
         Tx* tx = deserialize_tx(p, tx_size);
-        if (tx) {
-            b->txs[i] = *tx; 
-            free(tx);
-        }
+        if (!tx) goto bad;
+        b->txs[i] = *tx; 
+        free(tx);
         p += tx_size;
     }
 
     return b;
+
+bad:
+    printf("[P2P] Malformed block, dropped.\n");
+    free_block(b);
+    return NULL;
 }
 
 // ---- 发送消息（头 + payload） ----
@@ -293,29 +356,13 @@ void block_utxo_update(Block* block)
 
         Tx* tx = &block->txs[i];
 
-        // 移除已被花费的 UTXO
-        for (uint32_t j = 0; j < tx->input_count; j++) {
-
-            UTXO* prev = NULL, * cur = utxo_set;
-
-            while (cur) {
-                if (memcmp(cur->txid, tx->inputs[j].txid, 32) == 0 &&
-                    cur->output_index == tx->inputs[j].output_index)
-                {
-                    if (prev) prev->next = cur->next;
-                    else utxo_set = cur->next;
-
-                    free(cur);
-                    break;
-                }
-                prev = cur;
-                cur = cur->next;
-            }
-        }
+        // 移除已被花费的 UTXO（哈希表按键直接删除）
+        for (uint32_t j = 0; j < tx->input_count; j++)
+            remove_utxo(&utxo_set, tx->inputs[j].txid, tx->inputs[j].output_index);
 
         // 添加当前 tx 的输出为新的 UTXO
         for (uint32_t m = 0; m < tx->output_count; m++) {
-            add_utxo(&utxo_set, tx->txid, m,
+            add_utxo(&utxo_set, tx_txid(tx), m,
                 tx->outputs[m].addr,
                 tx->outputs[m].amount);
         }
@@ -444,9 +491,12 @@ void* peer_thread(void* arg)
 
                 Block* prev_block = last_chain ? last_chain->block : NULL;
 
-                if (verify_block(blk, prev_block)) {
+                if (verify_block_owned(blk, prev_block, block_spent_addr, utxo_set)) {
                     blockchain = blockchain_add(blockchain, blk);
                     block_utxo_update(blk);
+                    // 链尾已变化，本地正在挖的区块作废；放在更新链之后，
+                    // 这样在此之后取代数的挖矿一定能读到新链尾
+                    miner_cancel();
                     printf("[P2P] Block added from peer %d.\n", sock);
                 }
                 else {
@@ -633,7 +683,7 @@ void set_node_address(const char* addr, const unsigned char* pubkey) {
 
 //创造交易
 Tx* create_transaction(
-    UTXO** utxo_set,
+    UTXOSet** utxo_set,
     Mempool* mempool,
     const char* from_addr,
     const char* to_addr,
@@ -670,8 +720,8 @@ Tx* create_transaction(
         add_txout(tx, from_addr, changes);
     }
     sign_tx(tx, privkey);
-    //生成交易ID
-    tx_hash(tx, tx->txid);
+    //生成交易ID（签名时已算过，这里直接取缓存）
+    tx_txid(tx);
     //添加交易池
     tx_pool_add_tx(mempool, tx, *utxo_set);
     //更新utxo集
@@ -17,7 +17,7 @@
 
 // ----创建交易----
 Tx* create_transaction(
-    UTXO** utxo_set,                //全局 UTXO 集
+    UTXOSet** utxo_set,                //全局 UTXO 集
     Mempool* mempool,               //交易池
     const char* from_addr,          //发送地址
     const char* to_addr,            //接收地址
@@ -0,0 +1,51 @@
+#include "utils/cpu.h"
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+static CpuFeatures g_features;
+static pthread_once_t g_features_once = PTHREAD_ONCE_INIT;
+
+#if defined(__x86_64__) || defined(__i386__)
+// ȡ XCR0ȷϲϵͳᱣ YMM/ZMM Ĵ
+static unsigned long long read_xcr0(void) {
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((unsigned long long)hi << 32) | lo;
+}
+#endif
+
+static void detect_features(void) {
+    memset(&g_features, 0, sizeof(g_features));
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return;
+
+    g_features.ssse3 = (ecx >> 9) & 1;
+    g_features.sse41 = (ecx >> 19) & 1;
+
+    int osxsave = (ecx >> 27) & 1;
+    int avx = (ecx >> 28) & 1;
+    unsigned long long xcr0 = osxsave ? read_xcr0() : 0;
+    int ymm_ok = avx && (xcr0 & 0x6) == 0x6;        // XMM + YMM
+    int zmm_ok = ymm_ok && (xcr0 & 0xe0) == 0xe0;   // opmask + ZMM
+
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        g_features.avx2 = ymm_ok && ((ebx >> 5) & 1);
+        g_features.bmi2 = (ebx >> 8) & 1;
+        g_features.avx512f = zmm_ok && ((ebx >> 16) & 1);
+        g_features.sha = (ebx >> 29) & 1;
+    }
+#endif
+}
+
+//----ȡ CPU ----
+const CpuFeatures* cpu_features(void) {
+    pthread_once(&g_features_once, detect_features);
+    return &g_features;
+}
@@ -0,0 +1,17 @@
+#ifndef CPU_H
+#define CPU_H
+
+//----CPU ָԣʱͨ cpuid һΣ----
+typedef struct {
+    int ssse3;
+    int sse41;
+    int avx2;
+    int bmi2;
+    int avx512f;
+    int sha;        // Intel SHA չSHA-NI
+} CpuFeatures;
+
+//----ȡǰ CPU ֵ֧ԣ̰߳ȫֻһΣ----
+const CpuFeatures* cpu_features(void);
+
+#endif
@@ -1,8 +1,211 @@
 #include "hex.h"
+#include "utils/cpu.h"
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+static const char HEX_UPPER[16] = "0123456789ABCDEF";
+static const char HEX_LOWER[16] = "0123456789abcdef";
+
+// ַ -> ֽڣǷַΪ -1
+static const int8_t HEX_MAP[256] = {
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+     0, 1, 2, 3, 4, 5, 6, 7,  8, 9,-1,-1,-1,-1,-1,-1,
+    -1,10,11,12,13,14,15,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,10,11,12,13,14,15,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
+};
+
+// ----/ںˣǰ飬Ѵֽʣಿ߲----
+typedef size_t (*hex_encode_fn)(const uint8_t* in, size_t len, char* out, const char* digits);
+typedef size_t (*hex_decode_fn)(const char* hex, size_t nbytes, uint8_t* out);
+
+// ----ʵ----
+static void encode_tail(const uint8_t* in, size_t len, char* out, const char* digits) {
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = digits[in[i] >> 4];
+        out[2 * i + 1] = digits[in[i] & 15];
+    }
+}
+
+static int decode_tail(const char* hex, size_t nbytes, uint8_t* out) {
+    const unsigned char* s = (const unsigned char*)hex;
+    for (size_t i = 0; i < nbytes; i++) {
+        int hi = HEX_MAP[s[2 * i]];
+        int lo = HEX_MAP[s[2 * i + 1]];
+        if ((hi | lo) < 0) return 0;
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return 1;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// ----SSSE3ÿ 16 ֽ <-> 32 ַֽ pshufb ----
+__attribute__((target("ssse3")))
+static size_t encode_ssse3(const uint8_t* in, size_t len, char* out, const char* digits) {
+    const __m128i lut = _mm_loadu_si128((const __m128i*)digits);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+// 16 ַ -> 16 ֽڣvalid Ϊ 0xFFFF ʾȫϷ
+// '0'..'9'  '0'  [0,9]ĸ 0x20 ټ 'a'  [0,5]λַзűȽ¶
+__attribute__((target("ssse3")))
+static __m128i nibbles_ssse3(__m128i c, int* valid) {
+    __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i l = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_d = _mm_and_si128(_mm_cmpgt_epi8(d, _mm_set1_epi8(-1)), _mm_cmpgt_epi8(_mm_set1_epi8(10), d));
+    __m128i is_l = _mm_and_si128(_mm_cmpgt_epi8(l, _mm_set1_epi8(-1)), _mm_cmpgt_epi8(_mm_set1_epi8(6), l));
+    *valid = _mm_movemask_epi8(_mm_or_si128(is_d, is_l));
+    return _mm_or_si128(_mm_and_si128(is_d, d),
+                        _mm_and_si128(is_l, _mm_add_epi8(l, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("ssse3")))
+static size_t decode_ssse3(const char* hex, size_t nbytes, uint8_t* out) {
+    const __m128i weights = _mm_set1_epi16(0x0110);   // ÿַhi*16 + lo
+    size_t i = 0;
+    for (; i + 16 <= nbytes; i += 16) {
+        int v0, v1;
+        __m128i a = nibbles_ssse3(_mm_loadu_si128((const __m128i*)(hex + 2 * i)), &v0);
+        __m128i b = nibbles_ssse3(_mm_loadu_si128((const __m128i*)(hex + 2 * i + 16)), &v1);
+        if ((v0 & v1) != 0xFFFF) return (size_t)-1;
+        a = _mm_maddubs_epi16(a, weights);
+        b = _mm_maddubs_epi16(b, weights);
+        _mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+// ----AVX2ÿ 32 ֽ <-> 64 ַ----
+__attribute__((target("avx2")))
+static size_t encode_avx2(const uint8_t* in, size_t len, char* out, const char* digits) {
+    const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)digits));
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+        // unpack  128 λͨڽУٰͨŻ˳
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);   // ֽ 0..7 | 16..23
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);   // ֽ 8..15 | 24..31
+        _mm256_storeu_si256((__m256i*)(out + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    // ʣ಻ 32 ֽڵĲһ SSSE3
+    return i + encode_ssse3(in + i, len - i, out + 2 * i, digits);
+}
+
+__attribute__((target("avx2")))
+static __m256i nibbles_avx2(__m256i c, unsigned* valid) {
+    __m256i d = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i l = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_d = _mm256_and_si256(_mm256_cmpgt_epi8(d, _mm256_set1_epi8(-1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(10), d));
+    __m256i is_l = _mm256_and_si256(_mm256_cmpgt_epi8(l, _mm256_set1_epi8(-1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(6), l));
+    *valid = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(is_d, is_l));
+    return _mm256_or_si256(_mm256_and_si256(is_d, d),
+                           _mm256_and_si256(is_l, _mm256_add_epi8(l, _mm256_set1_epi8(10))));
+}
+
+__attribute__((target("avx2")))
+static size_t decode_avx2(const char* hex, size_t nbytes, uint8_t* out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t i = 0;
+    for (; i + 32 <= nbytes; i += 32) {
+        unsigned v0, v1;
+        __m256i a = nibbles_avx2(_mm256_loadu_si256((const __m256i*)(hex + 2 * i)), &v0);
+        __m256i b = nibbles_avx2(_mm256_loadu_si256((const __m256i*)(hex + 2 * i + 32)), &v1);
+        if ((v0 & v1) != 0xFFFFFFFFu) return (size_t)-1;
+        a = _mm256_maddubs_epi16(a, weights);
+        b = _mm256_maddubs_epi16(b, weights);
+        // packus Ҳǰͨa.lo b.lo a.hi b.hi -> a.lo a.hi b.lo b.hi
+        __m256i p = _mm256_packus_epi16(a, b);
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(p, 0xD8));
+    }
+    size_t rest = decode_ssse3(hex + 2 * i, nbytes - i, out + i);
+    return rest == (size_t)-1 ? rest : i + rest;
+}
+#endif
+
+// ---- cpuid ѡںˣֻѡһ----
+static hex_encode_fn g_encode;
+static hex_decode_fn g_decode;
+static pthread_once_t g_hex_once = PTHREAD_ONCE_INIT;
+
+static void select_kernels(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    const CpuFeatures* cpu = cpu_features();
+    if (cpu->avx2) {
+        g_encode = encode_avx2;
+        g_decode = decode_avx2;
+    } else if (cpu->ssse3) {
+        g_encode = encode_ssse3;
+        g_decode = decode_ssse3;
+    }
+#endif
+}
+
+// һ SSSE3 ֱӲʡ pthread_once ͼӵ
+#define HEX_SIMD_MIN 16
+
+static void encode_digits(const uint8_t* in, size_t len, char* out, const char* digits) {
+    size_t done = 0;
+    if (len >= HEX_SIMD_MIN) {
+        pthread_once(&g_hex_once, select_kernels);
+        if (g_encode) done = g_encode(in, len, out, digits);
+    }
+    encode_tail(in + done, len - done, out + 2 * done, digits);
+    out[2 * len] = '\0';
+}
+
+//----bytes ת hex----
+void hex_encode(const uint8_t* in, size_t len, char* out) {
+    encode_digits(in, len, out, HEX_UPPER);
+}
+
+void hex_encode_lower(const uint8_t* in, size_t len, char* out) {
+    encode_digits(in, len, out, HEX_LOWER);
+}
+
+//----hex ת bytes----
+int hex_decode(const char* hex, size_t hexlen, uint8_t* out) {
+    if (!hex || !out || hexlen % 2 != 0) return 0;
+
+    size_t nbytes = hexlen / 2, done = 0;
+    if (nbytes >= HEX_SIMD_MIN) {
+        pthread_once(&g_hex_once, select_kernels);
+        if (g_decode) {
+            done = g_decode(hex, nbytes, out);
+            if (done == (size_t)-1) return 0;
+        }
+    }
+    return decode_tail(hex + 2 * done, nbytes - done, out + done);
+}
 
-//----hexתbytes----
 int hex_bin(const char* hex, unsigned char* out, size_t outlen) {
 
     if (!hex || !out) return 0;
@@ -10,11 +213,5 @@ int hex_bin(const char* hex, unsigned char* out, size_t outlen) {
     size_t len = strlen(hex);
     if (len % 2 != 0 || len / 2 > outlen) return 0;
 
-    for (size_t i = 0; i < len / 2; i++) {
-        unsigned int byte;
-        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) return 0;
-        out[i] = (unsigned char)byte;
-    }
-
-    return 1;
+    return hex_decode(hex, len, out);
 }
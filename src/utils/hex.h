@@ -4,7 +4,18 @@
 #include <stddef.h>
 #include <stdint.h>
 
-//----hex ת bytes----
+// 밴 CPU ѡ AVX2 / SSSE3 / ʵ֣һ
+// ӡ txidϣȶҪֽ printf("%02X")
+
+//----bytes ת hexout  2*len+1 ֽڣĩβ '\0'----
+void hex_encode(const uint8_t* in, size_t len, char* out);          // д
+void hex_encode_lower(const uint8_t* in, size_t len, char* out);    // Сд
+
+//----hex ת byteshexlen Ϊżд hexlen/2 ֽڣСд----
+// ɹ 1Ϊ򺬷Ƿַ 0
+int hex_decode(const char* hex, size_t hexlen, uint8_t* out);
+
+//----hex ַ '\0' βת bytes----
 int hex_bin(const char* hex, unsigned char* out, size_t outlen);
 
 #endif
@@ -0,0 +1,159 @@
+#include "utils/thread_pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// һ thread_pool_run Σڵջ
+typedef struct {
+    thread_pool_fn fn;
+    void* ctx;
+    size_t count;
+    atomic_size_t next;             // һȡ
+} PoolBatch;
+
+struct ThreadPool {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;         // λҪ˳
+    pthread_cond_t done_cv;         // ̶߳뿪˵ǰ
+    pthread_mutex_t run_lock;       // ͬһʱִֻһ
+
+    PoolBatch* batch;               // ǰΣβʱ NULL
+    unsigned long generation;       // ÿһμһ
+    int busy;                       // ڴǰεĹ߳
+    int stop;
+
+    pthread_t* threads;
+    int thread_count;
+};
+
+static void run_batch(PoolBatch* b)
+{
+    size_t i;
+    while ((i = atomic_fetch_add(&b->next, 1)) < b->count)
+        b->fn(b->ctx, i);
+}
+
+static void* pool_worker(void* arg)
+{
+    ThreadPool* pool = arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->stop && pool->generation == seen)
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        if (pool->stop) break;
+
+        seen = pool->generation;
+        PoolBatch* b = pool->batch;
+        if (!b) continue;           // ѵ̫Ѿ
+
+        pool->busy++;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_batch(b);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0)
+            pthread_cond_signal(&pool->done_cv);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool* thread_pool_create(int threads)
+{
+    ThreadPool* pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+
+    if (threads > 0) {
+        pool->threads = calloc(threads, sizeof(pthread_t));
+        if (!pool->threads) threads = 0;
+    }
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, pool_worker, pool) != 0)
+            break;
+        pool->thread_count++;
+    }
+    return pool;
+}
+
+void thread_pool_destroy(ThreadPool* pool)
+{
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_cond_destroy(&pool->done_cv);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->run_lock);
+    free(pool->threads);
+    free(pool);
+}
+
+void thread_pool_run(ThreadPool* pool, thread_pool_fn fn, void* ctx, size_t count)
+{
+    PoolBatch b;
+    b.fn = fn;
+    b.ctx = ctx;
+    b.count = count;
+    atomic_init(&b.next, 0);
+
+    // ûйֻ̻߳һʱֱڵǰִ߳
+    if (!pool || pool->thread_count == 0 || count <= 1) {
+        run_batch(&b);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->run_lock);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->batch = &b;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_batch(&b);
+
+    // й߳뿪Σb ܳջ
+    pthread_mutex_lock(&pool->lock);
+    pool->batch = NULL;
+    while (pool->busy > 0)
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->run_lock);
+}
+
+int thread_pool_size(const ThreadPool* pool)
+{
+    return pool ? pool->thread_count + 1 : 1;
+}
+
+static ThreadPool* g_shared_pool = NULL;
+static pthread_once_t g_shared_once = PTHREAD_ONCE_INIT;
+
+static void create_shared_pool(void)
+{
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    g_shared_pool = thread_pool_create(ncpu > 1 ? (int)ncpu - 1 : 0);
+}
+
+ThreadPool* thread_pool_shared(void)
+{
+    pthread_once(&g_shared_once, create_shared_pool);
+    return g_shared_pool;
+}
@@ -0,0 +1,25 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <stddef.h>
+
+//----̶СĹ̳߳أ count ִָ̲߳----
+typedef struct ThreadPool ThreadPool;
+
+// index Ϊ [0, count) еһ
+typedef void (*thread_pool_fn)(void* ctx, size_t index);
+
+//---- / ٣threads ΪĹ߳Ϊ 0----
+ThreadPool* thread_pool_create(int threads);
+void thread_pool_destroy(ThreadPool* pool);
+
+//----ִ fn(ctx, 0..count-1)߳Ҳ룬ȫɺ󷵻----
+// ͬһ̳߳ϵĶεûŶִУҪٶͬһص
+void thread_pool_run(ThreadPool* pool, thread_pool_fn fn, void* ctx, size_t count);
+
+//----߳߳ + ̣߳----
+int thread_pool_size(const ThreadPool* pool);
+
+//----ڹ̳߳أһʹʱ CPU ----
+ThreadPool* thread_pool_shared(void);
+
+#endif
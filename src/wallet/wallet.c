@@ -4,12 +4,16 @@
 #include <time.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include <openssl/sha.h>
-#include <openssl/evp.h>
 #include <stdlib.h>
 #include <secp256k1.h>
+#include <secp256k1_recovery.h>
 #include "wallet/wallet.h"
 #include "crypto/base58check.h"
+#include "crypto/hash.h"
+#include "crypto/crypto_tools.h"
+#include "crypto/pubkey_cache.h"
+#include "core/check_queue.h"
+#include "utils/thread_pool.h"
 //#include "../crypto/crypto_tools.h" // hash160, pubkey_to_address
 //#include "../crypto/double_sha256.h"
 //#include "../crypto/sha256.h"
@@ -54,10 +58,9 @@ void privkey_to_WIF(unsigned char* priv, int priv_len, int compressed, char* wif
         payload[payload_size] = 0x01; payload_size += 1; 
     }
 
-    // ˫ SHA256 У룬ʹsha256
-    unsigned char hash1[32], hash2[32], final[38];
-    SHA256(payload, payload_size, hash1);   // һ SHA256
-    SHA256(hash1, 32, hash2);               // ڶ SHA256
+    // ˫ SHA256 У
+    unsigned char hash2[32], final[38];
+    hash_sha256d(payload, payload_size, hash2);
 
     // ֽ
     memcpy(final, payload, payload_size);
@@ -77,20 +80,18 @@ int privkey_to_pubkey_and_addr(
 ) {
     if (!priv_key || !pub_key_out || !pub_key_out_len || !addr_out) return 0;
 
-    //  secp256k1 
-    secp256k1_context* ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    //  secp256k1 ģֻһΣ
+    secp256k1_context* ctx = crypto_secp_get_context();
     if (!ctx) return 0;
 
     // ֤˽Կ
     if (!secp256k1_ec_seckey_verify(ctx, priv_key)) {
-        secp256k1_context_destroy(ctx);
         return 0;
     }
 
     // ˽ԿɹԿ
     secp256k1_pubkey pub_key;
     if (!secp256k1_ec_pubkey_create(ctx, &pub_key, priv_key)) {
-        secp256k1_context_destroy(ctx);
         return 0;
     }
 
@@ -102,150 +103,207 @@ int privkey_to_pubkey_and_addr(
         secp256k1_ec_pubkey_serialize(ctx, pub_key_out, &publen, &pub_key, SECP256K1_EC_UNCOMPRESSED);
     *pub_key_out_len = publen;
 
-    // ----HASH160(publickey)----
-    // HASH160 = RIPEMD160(SHA256(pubkey))
-    unsigned char sha[32], ripemd_hash[20]; 
-    unsigned int ripemdlen;
-    SHA256(pub_key_out, publen, sha);
-    EVP_MD_CTX* ctx2 = EVP_MD_CTX_new();
-    EVP_DigestInit_ex(ctx2, EVP_ripemd160(), NULL);
-    EVP_DigestUpdate(ctx2, sha, 32);
-    EVP_DigestFinal_ex(ctx2, ripemd_hash, &ripemdlen);
-    EVP_MD_CTX_free(ctx2);
+    return pubkey_to_addr(pub_key_out, publen, addr_out, addr_out_len);
+}
 
+//----HASH160 ɵַ汾 0xA1 + HASH160 + ˫ SHA256 Уǰ 4 ֽڣ Base58 ----
+static void hash160_to_addr(const unsigned char ripemd_hash[20], char* addr_out, int addr_out_len) {
     // ----ɵַ payloadУ----
     unsigned char payload[21];
-    unsigned char checksum1[32], checksum2[32], final[25];
+    unsigned char checksum2[32], final[25];
     payload[0] = 0xA1; 
 
     memcpy(payload + 1, ripemd_hash, 20);
-    SHA256(payload, 21, checksum1);
-    SHA256(checksum1, 32, checksum2);
+    hash_sha256d(payload, 21, checksum2);
 
     // ֽ = payload + Уǰ 4 ֽ
     memcpy(final, payload, 21);
     memcpy(final + 21, checksum2, 4);
 
     Base58check_encode(final, 25, addr_out, addr_out_len);
-    secp256k1_context_destroy(ctx);
+}
+
+//----Կɵַ----
+int pubkey_to_addr(const unsigned char* pub, size_t publen, char* addr_out, int addr_out_len) {
+    if (!pub || !addr_out) return 0;
 
+    // ----HASH160(publickey)----
+    // HASH160 = RIPEMD160(SHA256(pubkey))
+    unsigned char ripemd_hash[20];
+    hash160(pub, publen, ripemd_hash);
+
+    hash160_to_addr(ripemd_hash, addr_out, addr_out_len);
     return 1;
 }
 
+//----Կɵַ----
+int pubkeys_to_addrs(const unsigned char* pubs, size_t publen, size_t count, char* addr_out, int addr_out_len) {
+    if (!pubs || !addr_out) return 0;
+
+    unsigned char* hashes = malloc(count * 20 + 1);
+    unsigned char* payloads = malloc(count * 21 + 1);
+    if (!hashes || !payloads) { free(hashes); free(payloads); return 0; }
+
+    // HASH160 У붼㣨໺ SIMDpayload = 0xA1 + HASH160
+    hash160_batch(pubs, publen, count, hashes);
+    for (size_t i = 0; i < count; i++) {
+        payloads[21 * i] = 0xA1;
+        memcpy(payloads + 21 * i + 1, hashes + 20 * i, 20);
+    }
+    size_t ok = base58check_encode_batch(payloads, 21, count, addr_out, (size_t)addr_out_len);
+
+    free(hashes);
+    free(payloads);
+    return ok == count;
+}
+
 // ----㽻׹ϣ----
 void tx_hash(const Tx* tx, unsigned char hash_out[32]) {
 
-    EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
-    EVP_DigestInit_ex(mdctx, EVP_sha256(), NULL);
+    // ջϣÿη EVP_MD_CTX
+    HashCtx ctx;
+    hash_init(&ctx);
 
     // ÿժҪ
     for (uint32_t i = 0; i < tx->input_count; i++) {
-        EVP_DigestUpdate(mdctx, tx->inputs[i].txid, 32);
+        hash_update(&ctx, tx->inputs[i].txid, 32);
 
-        EVP_DigestUpdate(mdctx, &tx->inputs[i].output_index, sizeof(uint32_t));
+        hash_update(&ctx, &tx->inputs[i].output_index, sizeof(uint32_t));
     }
 
     // ÿժҪ
     for (uint32_t i = 0; i < tx->output_count; i++) {
-        EVP_DigestUpdate(mdctx, tx->outputs[i].addr, strlen(tx->outputs[i].addr));
-        EVP_DigestUpdate(mdctx, &tx->outputs[i].amount, sizeof(uint32_t));
+        hash_update(&ctx, tx->outputs[i].addr, strlen(tx->outputs[i].addr));
+        hash_update(&ctx, &tx->outputs[i].amount, sizeof(uint32_t));
     }
 
-    unsigned int outlen;
-
-    EVP_DigestFinal_ex(mdctx, hash_out, &outlen);
+    // coinbase û룬ժҪڿʱµ merkle 
+    if (tx->input_count == 0)
+        hash_update(&ctx, &tx->extranonce, sizeof(uint32_t));
 
+    hash_final(&ctx, hash_out);
+}
 
-    EVP_MD_CTX_free(mdctx);
+// ----IDtxid_valid Ϊ 0 ʱ¹ϣ----
+const unsigned char* tx_txid(Tx* tx) {
+    if (!tx->txid_valid) {
+        tx_hash(tx, tx->txid);
+        tx->txid_valid = 1;
+    }
+    return tx->txid;
 }
 
 
 //----ǩ----
 // Խ tx ÿʹ˽Կ priv ǩ
+// ʹÿɻָǩ65 ֽڣﲻЯԿ֤ǩָ
 //  1 ʾɹ0 ʾʧ
 int sign_tx(Tx* tx, const unsigned char* priv) {
     if (!tx || !priv) return 0;
 
-    secp256k1_context* ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
-    if (!ctx) return 0;
+    const unsigned char (*privs)[32] = (const unsigned char (*)[32])priv;
+    return sign_tx_keys(tx, privs, 1, NULL);
+}
+
+// ÿ˽Կǩ
+typedef struct {
+    const unsigned char (*privs)[32];
+    const unsigned char* hash;
+    unsigned char (*sigs)[65];
+    int* ok;
+} SignKeysCtx;
+
+// ǩȷԵģRFC6979ͬһ˽ԿͬһϣֻǩһΣ빲
+static void sign_key_task(void* arg, size_t k) {
+    SignKeysCtx* c = arg;
+    secp256k1_context* ctx = crypto_secp_get_context();
+    const unsigned char* priv = c->privs[k];
+    c->ok[k] = 0;
 
     // ֤˽Կ
-    if (!secp256k1_ec_seckey_verify(ctx, priv)) {
-        secp256k1_context_destroy(ctx);
+    if (!secp256k1_ec_seckey_verify(ctx, priv))
+        return;
+
+    secp256k1_ecdsa_recoverable_signature sig;
+    if (!secp256k1_ecdsa_sign_recoverable(ctx, &sig, c->hash, priv, NULL, NULL))
+        return;
+
+    // compact 64 ֽ + recid 1 ֽ
+    int recid;
+    secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, c->sigs[k], &recid, &sig);
+    c->sigs[k][64] = (unsigned char)recid;
+
+    // Կÿ˽ԿֻһΣŽ棬֤֮ԼĽʱٻָ
+    secp256k1_pubkey pub;
+    if (!secp256k1_ec_pubkey_create(ctx, &pub, priv))
+        return;
+    pubkey_cache_insert_recovered(c->sigs[k], c->hash, &pub);
+
+    c->ok[k] = 1;
+}
+
+//----˽Կǩ----
+// ˽Կ֮ڹ̳߳ϲǩֱӿӦ˽Կǩ
+int sign_tx_keys(Tx* tx, const unsigned char (*privs)[32], size_t key_count, const uint32_t* key_of_input) {
+    if (!tx || !privs || key_count == 0) return 0;
+    if (!crypto_secp_get_context()) return 0;
+
+    // txid ڲ֮ǰãֻ
+    const unsigned char* hash = tx_txid(tx);
+
+    unsigned char (*sigs)[65] = malloc(key_count * sizeof(*sigs));
+    int* ok = malloc(key_count * sizeof(int));
+    if (!sigs || !ok) {
+        free(sigs);
+        free(ok);
         return 0;
     }
 
-    unsigned char hash[32];
-    tx_hash(tx, hash);
+    SignKeysCtx c = { privs, hash, sigs, ok };
+    thread_pool_run(thread_pool_shared(), sign_key_task, &c, key_count);
 
-    for (uint32_t i = 0; i < tx->input_count; i++) {
-        secp256k1_ecdsa_signature sig;
-        if (!secp256k1_ecdsa_sign(ctx, &sig, hash, priv, NULL, NULL)) {
-            secp256k1_context_destroy(ctx);
-            return 0;
-        }
-        // ǩлΪ compact ʽ,Ȼ󱣴
-        secp256k1_ecdsa_signature_serialize_compact(ctx, tx->inputs[i].signature, &sig);
-        tx->inputs[i].sig_len = 64;
-
-        // Կ
-        secp256k1_pubkey pub;
-        if (!secp256k1_ec_pubkey_create(ctx, &pub, priv)) {//ûȷԿ
-            secp256k1_context_destroy(ctx);
-            return 0; 
-        }
-
-        // лԿ
-        size_t publen = 65;
-        if (!secp256k1_ec_pubkey_serialize(ctx, tx->inputs[i].pubkey, &publen, &pub, SECP256K1_EC_UNCOMPRESSED)) {//ûȷл
-            secp256k1_context_destroy(ctx);
-            return 0; 
-        }
-        tx->inputs[i].pubkey_len = publen;
+    // ȼȫ룬һоʲֻǩһĽ
+    int result = 1;
+    for (uint32_t i = 0; i < tx->input_count && result; i++) {
+        uint32_t k = key_of_input ? key_of_input[i] : 0;
+        result = k < key_count && ok[k];
     }
 
-    //ͷڴ
-    secp256k1_context_destroy(ctx);
-    return 1;
+    for (uint32_t i = 0; i < tx->input_count && result; i++) {
+        uint32_t k = key_of_input ? key_of_input[i] : 0;
+        TxIn* in = &tx->inputs[i];
+        memcpy(in->signature, sigs[k], 65);
+        in->sig_len = TXIN_SIG_RECOVERABLE;
+        in->pubkey_len = 0;
+    }
+
+    free(sigs);
+    free(ok);
+    return result;
 }
 
 
 
 
 // ----֤ǩ----
-// ֤ tx ÿǷɶӦ˽Կǩ
-//  1 ʾǩЧ0 ʾЧǩ
-int verify_tx(const Tx* tx) {
+// ֤ tx ÿǷɱտַӦ˽Կǩ϶ʱв֤
+// ֤ͨǩдǩ棬֮鵽ʱظǩ
+//  1 ʾǩЧ0 ʾЧǩ򱻻ѵ utxos 
+int verify_tx(Tx* tx, UTXOSet* utxos) {
     if (!tx) return 0;
 
-    secp256k1_context* ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
-    if (!ctx) return 0;
-
-    // 㽻׹ϣ SHA256 ժҪ
-    unsigned char hash[32];
-    tx_hash(tx, hash);
-
-    // ׵ÿ
-    for (uint32_t j = 0; j < tx->input_count; j++) {
-        secp256k1_pubkey pub;
-        // Կ
-        if (!secp256k1_ec_pubkey_parse(ctx, &pub, tx->inputs[j].pubkey, tx->inputs[j].pubkey_len)) {
-            secp256k1_context_destroy(ctx);
-            return 0;
-        }
-        // ǩ
-        secp256k1_ecdsa_signature sig;
-        if (!secp256k1_ecdsa_signature_parse_compact(ctx, &sig, tx->inputs[j].signature)) {
-            secp256k1_context_destroy(ctx);
-            return 0;
-        }
-        if (!secp256k1_ecdsa_verify(ctx, &sig, hash, &pub)) {
-            secp256k1_context_destroy(ctx);
-            return 0;
-        }
+    const unsigned char* txid = tx_txid(tx);
+    SigCheckQueue q;
+    check_queue_init(&q);
+    q.cache_store = 1;
+    int ok = 1;
+    for (uint32_t i = 0; i < tx->input_count && ok; i++) {
+        UTXO* utxo = find_utxo(utxos, tx->inputs[i].txid, tx->inputs[i].output_index);
+        ok = utxo && check_queue_push_input(&q, txid, &tx->inputs[i], utxo->hash160);
     }
-    secp256k1_context_destroy(ctx);
-    return 1;
+    ok = ok && check_queue_wait(&q);
+    check_queue_free(&q);
+    return ok;
 }
 
 
@@ -4,14 +4,22 @@
 #include <stdint.h>
 #include "core/block/block.h"
 #include "core/transaction.h"
+#include "core/utxo_set.h"
 
 //----ǩ----//
 int sign_tx(Tx* tx, const unsigned char* priv);
+
+//----˽Կǩprivs Ϊ key_count  32 ֽ˽Կkey_of_input[i] Ϊ i õ˽Կ----//
+//----key_of_input Ϊ NULL ʱȫʹ privs[0]ÿ˽ԿֻǩһΡֻһιԿ----//
+int sign_tx_keys(Tx* tx, const unsigned char (*privs)[32], size_t key_count, const uint32_t* key_of_input);
 //----׹ϣ----//
 void tx_hash(const Tx* tx, unsigned char out[32]);
 
-//----֤ǩ----//
-int verify_tx(const Tx* tx);
+//----ID tx->txidʧЧʱ¼㣩----//
+const unsigned char* tx_txid(Tx* tx);
+
+//----֤ǩÿǩ utxos бտַ----//
+int verify_tx(Tx* tx, UTXOSet* utxos);
 
 //----˽Կ----//
 void generate_privkey(unsigned char* priv);
@@ -25,6 +33,12 @@ void privkey_to_WIF(
 	int outlen
 );
 
+//----ԿɵַHASH160 + 汾 0xA1 + Base58Check----//
+int pubkey_to_addr(const unsigned char* pub, size_t publen, char* addrout, int addroutlen);
+
+//----Կɵַcount ȳԿţ i ַд addrout + i*addroutlen----//
+int pubkeys_to_addrs(const unsigned char* pubs, size_t publen, size_t count, char* addrout, int addroutlen);
+
 //----˽ԿɹԿ͵ַ----//
 int privkey_to_pubkey_and_addr(
 	const unsigned char* priv, 